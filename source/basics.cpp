@@ -57,7 +57,7 @@ std::vector<std::string> splitString(char toSplit, std::string s)
   auto result     = std::vector<std::string>();
   auto tempBuffer = std::string();
 
-  for (uint64_t i = 0; i < s.length(); i++)
+  for (index_t i = 0; i < s.length(); i++)
   {
     auto cur = s[i];
 
@@ -106,4 +106,56 @@ void removeAllInsideDir(std::string path)
   }
   
   closedir(dir);
+}
+
+#ifdef ARM9
+static volatile uint32_t stopwatchWraps = 0;
+
+static void stopwatchWrapped()
+{
+  stopwatchWraps++;
+}
+#endif
+
+Stopwatch::Stopwatch()
+{
+  start = clock();
+
+#ifdef ARM9
+  cpuStartTiming(0);
+
+  stopwatchWraps = 0;
+  TIMER_CR(1)   |= TIMER_IRQ_REQ;
+
+  irqSet(IRQ_TIMER(1), stopwatchWrapped);
+  irqEnable(IRQ_TIMER(1));
+#endif
+}
+
+uint64_t Stopwatch::elapsedUsec()
+{
+#ifdef ARM9
+  uint32_t wraps, ticks;
+
+  // a wrap between the two reads would pair the new count with the old ticks
+  do
+  {
+    wraps = stopwatchWraps;
+    ticks = cpuGetTiming();
+  }
+  while (wraps != stopwatchWraps);
+
+  return ((uint64_t(wraps) << 32) | ticks) * 1000000 / BUS_CLOCK;
+#else
+  return uint64_t(clock() - start) * 1000000 / CLOCKS_PER_SEC;
+#endif
+}
+
+std::string formatThroughput(uint64_t bytes, uint64_t usec)
+{
+  // bytes per microsecond are megabytes per second, kept in hundredths to print two decimals without floats
+  auto hundredths = bytes * 100 / (usec > 0 ? usec : 1);
+  auto decimals   = std::to_string(hundredths % 100);
+
+  return std::to_string(hundredths / 100) + "." + (decimals.length() < 2 ? "0" : "") + decimals + " MB/s";
 }
\ No newline at end of file
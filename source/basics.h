@@ -1,6 +1,8 @@
 #pragma once
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <c++/12.1.0/vector>
 #include <c++/12.1.0/functional>
 #include <c++/12.1.0/algorithm>
@@ -9,6 +11,12 @@
 typedef const char* cstring_t;
 typedef char void_t;
 
+// indexes, lengths and offsets into prompts and expressions: the arm9 word, where 64 bits ones take a register pair and a carry for each operation
+typedef uint32_t index_t;
+
+// the texts longer than this are refused where they come in, so an index_t never wraps
+#define INDEX_MAX UINT32_MAX
+
 void panic(std::string msg);
 
 // NOTE: `s` won't be freed
@@ -30,11 +38,31 @@ std::string getRealPath(std::string path);
 
 std::vector<std::string> splitString(char toSplit, std::string s);
 
+// -ffast-math lets the compiler assume no value is infinite or nan, folding away `isfinite(x)` and `x != x`,
+// so these test the exponent and mantissa bits instead
+inline uint64_t floatBits(double x)
+{
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+
+  return bits;
+}
+
+inline bool isFiniteFloat(double x)
+{
+  return (floatBits(x) >> 52 & 0x7FF) != 0x7FF;
+}
+
+inline bool isNanFloat(double x)
+{
+  return !isFiniteFloat(x) && (floatBits(x) & 0xFFFFFFFFFFFFFull) != 0;
+}
+
 template <typename T> std::string joinArray(std::string sep, std::vector<T> arr, std::function<std::string(T)> toStringRemapper)
 {
   auto result = std::string();
 
-  for (uint64_t i = 0; i < arr.size(); i++)
+  for (index_t i = 0; i < arr.size(); i++)
   {
     // when this is not the first element
     if (i > 0)
@@ -50,6 +78,20 @@ std::string addTrailingSlashToPath(std::string dir);
 
 void removeAllInsideDir(std::string path);
 
+// microseconds timer started at construction, on the ds it uses the two cascading timers 0 and 1,
+// whose 32 bits wrap every 128 seconds, so the interrupt of timer 1 counts the wraps
+class Stopwatch
+{
+  private: clock_t start;
+
+  public: Stopwatch();
+
+  public: uint64_t elapsedUsec();
+};
+
+// `bytes` transferred in `usec`, as `12.34 MB/s`
+std::string formatThroughput(uint64_t bytes, uint64_t usec);
+
 template<typename Tk, typename Tv> class KeyPair
 {
   public: Tk key;
@@ -0,0 +1,517 @@
+#include "bignum.h"
+#include "numeric.h"
+
+#include <math.h>
+
+// the biggest power of 10 fitting in a limb, used to convert from and to base 10 nine digits at a time
+#define BIGINT_DECIMAL_CHUNK       1000000000u
+#define BIGINT_DECIMAL_CHUNK_DIGITS 9
+
+static inline size_t trimmedLength(const uint32_t* a, size_t n)
+{
+  while (n > 0 && a[n - 1] == 0)
+    n--;
+
+  return n;
+}
+
+static int compareMagnitudes(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+  if (a.size() != b.size())
+    return a.size() < b.size() ? -1 : 1;
+
+  for (size_t i = a.size(); i-- > 0;)
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+
+  return 0;
+}
+
+// dst += src, `dst` must be long enough to absorb the final carry
+static void addInto(uint32_t* dst, size_t dstLen, const uint32_t* src, size_t srcLen)
+{
+  uint64_t carry = 0;
+  size_t   i     = 0;
+
+  for (; i < srcLen; i++)
+  {
+    carry += uint64_t(dst[i]) + src[i];
+    dst[i] = uint32_t(carry);
+    carry >>= 32;
+  }
+
+  for (; carry != 0 && i < dstLen; i++)
+  {
+    carry += dst[i];
+    dst[i] = uint32_t(carry);
+    carry >>= 32;
+  }
+}
+
+// dst -= src, the magnitude in `dst` must be greater or equal than the one in `src`
+static void subInto(uint32_t* dst, size_t dstLen, const uint32_t* src, size_t srcLen)
+{
+  uint32_t borrow = 0;
+  size_t   i      = 0;
+
+  for (; i < srcLen; i++)
+  {
+    auto d = uint64_t(dst[i]) - src[i] - borrow;
+    dst[i] = uint32_t(d);
+    borrow = uint32_t(d >> 63);
+  }
+
+  for (; borrow != 0 && i < dstLen; i++)
+  {
+    borrow = dst[i] == 0;
+    dst[i]--;
+  }
+}
+
+// out[0 .. an + bn] = a * b, `out` must be zeroed
+static void mulSchoolbook(const uint32_t* a, size_t an, const uint32_t* b, size_t bn, uint32_t* out)
+{
+  for (size_t i = 0; i < an; i++)
+  {
+    uint64_t carry = 0;
+    auto     ai    = a[i];
+
+    if (ai == 0)
+      continue;
+
+    // the partial product never overflows: (2^32-1)^2 + 2 * (2^32-1) == 2^64-1
+    for (size_t j = 0; j < bn; j++)
+    {
+      carry     += uint64_t(ai) * b[j] + out[i + j];
+      out[i + j] = uint32_t(carry);
+      carry    >>= 32;
+    }
+
+    out[i + bn] = uint32_t(carry);
+  }
+}
+
+// out[0 .. an + bn] = a * b, `out` must be zeroed
+static void mulMagnitudes(const uint32_t* a, size_t an, const uint32_t* b, size_t bn, uint32_t* out)
+{
+  an = trimmedLength(a, an);
+  bn = trimmedLength(b, bn);
+
+  // making `a` always the longest operand
+  if (an < bn)
+  {
+    std::swap(a, b);
+    std::swap(an, bn);
+  }
+
+  if (bn == 0)
+    return;
+
+  if (bn < BIGINT_KARATSUBA_THRESHOLD)
+  {
+    mulSchoolbook(a, an, b, bn, out);
+    return;
+  }
+
+  // unbalanced operands, `a` is sliced in chunks as long as `b` so that every product is balanced
+  if (an >= 2 * bn)
+  {
+    auto partial = std::vector<uint32_t>(2 * bn);
+
+    for (size_t i = 0; i < an; i += bn)
+    {
+      auto chunkLen = std::min(bn, an - i);
+
+      std::fill(partial.begin(), partial.end(), 0);
+      mulMagnitudes(a + i, chunkLen, b, bn, partial.data());
+      addInto(out + i, an + bn - i, partial.data(), chunkLen + bn);
+    }
+
+    return;
+  }
+
+  // karatsuba: a = a1*B^h + a0, b = b1*B^h + b0
+  //  a*b = z2*B^2h + (z1 - z2 - z0)*B^h + z0
+  //  where z0 = a0*b0, z2 = a1*b1, z1 = (a0+a1)*(b0+b1)
+  // `bn > half` is guaranteed by the unbalanced check above, so `b1` is never empty
+  auto half = an / 2;
+  auto a1n  = an - half;
+  auto b1n  = bn - half;
+
+  auto z0 = std::vector<uint32_t>(2 * half);
+  auto z2 = std::vector<uint32_t>(a1n + b1n);
+
+  mulMagnitudes(a, half, b, half, z0.data());
+  mulMagnitudes(a + half, a1n, b + half, b1n, z2.data());
+
+  // a1 is always at least as long as a0, while b1 may be shorter than b0
+  auto sa = std::vector<uint32_t>(a + half, a + an);
+  sa.push_back(0);
+  addInto(sa.data(), sa.size(), a, half);
+
+  auto sb = std::vector<uint32_t>(std::max(half, b1n) + 1);
+  std::copy(b, b + half, sb.begin());
+  addInto(sb.data(), sb.size(), b + half, b1n);
+
+  auto z1 = std::vector<uint32_t>(sa.size() + sb.size());
+  mulMagnitudes(sa.data(), sa.size(), sb.data(), sb.size(), z1.data());
+
+  auto z0n = trimmedLength(z0.data(), z0.size());
+  auto z2n = trimmedLength(z2.data(), z2.size());
+
+  subInto(z1.data(), z1.size(), z0.data(), z0n);
+  subInto(z1.data(), z1.size(), z2.data(), z2n);
+
+  auto outLen = an + bn;
+
+  addInto(out, outLen, z0.data(), z0n);
+  addInto(out + half, outLen - half, z1.data(), trimmedLength(z1.data(), z1.size()));
+  addInto(out + 2 * half, outLen - 2 * half, z2.data(), z2n);
+}
+
+// a = a * m + add
+static void mulSmallAdd(std::vector<uint32_t>& a, uint32_t m, uint32_t add)
+{
+  uint64_t carry = add;
+
+  for (auto& limb : a)
+  {
+    carry += uint64_t(limb) * m;
+    limb   = uint32_t(carry);
+    carry >>= 32;
+  }
+
+  if (carry != 0)
+    a.push_back(uint32_t(carry));
+}
+
+// a = a / d, returns a % d
+static uint32_t divModSmall(std::vector<uint32_t>& a, uint32_t d)
+{
+  uint64_t rem = 0;
+
+  // with a 31 bits divisor the partial dividend stays below 2^63, so it fits the signed hardware divider
+  if (d <= INT32_MAX)
+  {
+    for (size_t i = a.size(); i-- > 0;)
+    {
+      auto r = Numeric::divMod64(int64_t((rem << 32) | a[i]), d);
+
+      a[i] = uint32_t(r.quot);
+      rem  = uint64_t(r.rem);
+    }
+  }
+  else
+  {
+    for (size_t i = a.size(); i-- > 0;)
+    {
+      auto cur = (rem << 32) | a[i];
+
+      a[i] = uint32_t(cur / d);
+      rem  = cur % d;
+    }
+  }
+
+  a.resize(trimmedLength(a.data(), a.size()));
+  return uint32_t(rem);
+}
+
+// knuth's algorithm d (taocp vol 2, 4.3.1), with the formulation of hacker's delight (divmnu64)
+// `v` must have at least 2 limbs and `u` must be at least as long as `v`
+static void divModMagnitudes(const std::vector<uint32_t>& u, const std::vector<uint32_t>& v, std::vector<uint32_t>& q, std::vector<uint32_t>& r)
+{
+  auto n = v.size();
+  auto m = u.size() - n;
+
+  // normalizing so that the top limb of the divisor has its high bit set, this keeps `qhat` off by 2 at most
+  auto s  = __builtin_clz(v[n - 1]);
+  auto vn = std::vector<uint32_t>(n);
+  auto un = std::vector<uint32_t>(m + n + 1);
+
+  for (size_t i = n - 1; i > 0; i--)
+    vn[i] = (v[i] << s) | uint32_t(uint64_t(v[i - 1]) >> (32 - s));
+
+  vn[0] = v[0] << s;
+
+  un[m + n] = uint32_t(uint64_t(u[m + n - 1]) >> (32 - s));
+
+  for (size_t i = m + n - 1; i > 0; i--)
+    un[i] = (u[i] << s) | uint32_t(uint64_t(u[i - 1]) >> (32 - s));
+
+  un[0] = u[0] << s;
+
+  q.assign(m + 1, 0);
+
+  for (size_t j = m + 1; j-- > 0;)
+  {
+    // estimating the quotient limb from the top two limbs
+    auto num  = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+    auto qhat = num / vn[n - 1];
+    auto rhat = num % vn[n - 1];
+
+    while (qhat >> 32 != 0 || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+    {
+      qhat--;
+      rhat += vn[n - 1];
+
+      if (rhat >> 32 != 0)
+        break;
+    }
+
+    // multiplying and subtracting
+    int64_t k = 0;
+    int64_t t;
+
+    for (size_t i = 0; i < n; i++)
+    {
+      auto p = qhat * vn[i];
+
+      t          = int64_t(un[i + j]) - k - int64_t(p & 0xFFFFFFFF);
+      un[i + j]  = uint32_t(t);
+      k          = int64_t(p >> 32) - (t >> 32);
+    }
+
+    t         = int64_t(un[j + n]) - k;
+    un[j + n] = uint32_t(t);
+    q[j]      = uint32_t(qhat);
+
+    // the estimate was one too big, adding back
+    if (t < 0)
+    {
+      uint64_t carry = 0;
+
+      q[j]--;
+
+      for (size_t i = 0; i < n; i++)
+      {
+        carry     += uint64_t(un[i + j]) + vn[i];
+        un[i + j]  = uint32_t(carry);
+        carry    >>= 32;
+      }
+
+      un[j + n] += uint32_t(carry);
+    }
+  }
+
+  // unnormalizing the remainder
+  r.assign(n, 0);
+
+  for (size_t i = 0; i < n; i++)
+    r[i] = (un[i] >> s) | uint32_t(uint64_t(un[i + 1]) << (32 - s));
+
+  q.resize(trimmedLength(q.data(), q.size()));
+  r.resize(trimmedLength(r.data(), r.size()));
+}
+
+BigInt::BigInt(int64_t value)
+{
+  // the magnitude of INT64_MIN is computed in unsigned arithmetic to avoid overflowing
+  auto magnitude = value < 0 ? 0 - uint64_t(value) : uint64_t(value);
+
+  this->negative = value < 0;
+  this->limbs    = std::vector<uint32_t>();
+
+  if (magnitude != 0)
+    limbs.push_back(uint32_t(magnitude));
+
+  if (magnitude >> 32 != 0)
+    limbs.push_back(uint32_t(magnitude >> 32));
+}
+
+BigInt BigInt::fromString(std::string digits)
+{
+  auto result = BigInt();
+
+  // the first chunk takes the leftover digits, so that all the following ones are exactly 9 digits long
+  auto firstChunkLength = digits.length() % BIGINT_DECIMAL_CHUNK_DIGITS;
+
+  if (firstChunkLength == 0)
+    firstChunkLength = BIGINT_DECIMAL_CHUNK_DIGITS;
+
+  for (size_t i = 0; i < digits.length();)
+  {
+    auto     chunkLength = i == 0 ? firstChunkLength : BIGINT_DECIMAL_CHUNK_DIGITS;
+    uint32_t chunk       = 0;
+    uint32_t multiplier  = 1;
+
+    for (size_t j = 0; j < chunkLength; j++)
+    {
+      chunk       = chunk * 10 + uint32_t(digits[i + j] - '0');
+      multiplier *= 10;
+    }
+
+    mulSmallAdd(result.limbs, multiplier, chunk);
+    i += chunkLength;
+  }
+
+  result.trim();
+  return result;
+}
+
+bool BigInt::fromFloat(float64 value, BigInt& result)
+{
+  // dividing infinity never gets it below 1
+  if (!isFiniteFloat(value))
+    return false;
+
+  auto magnitude = fabs(value);
+
+  result = BigInt();
+
+  // dividing by a power of 2 is exact, so every limb is extracted without rounding
+  while (magnitude >= 1)
+  {
+    result.limbs.push_back(uint32_t(fmod(magnitude, 4294967296.0)));
+    magnitude = floor(magnitude / 4294967296.0);
+  }
+
+  result.negative = value < 0;
+  result.trim();
+  return true;
+}
+
+std::string BigInt::toString() const
+{
+  if (isZero())
+    return "0";
+
+  auto magnitude = limbs;
+  auto chunks    = std::vector<uint32_t>();
+
+  // extracting 9 decimal digits per division, instead of one
+  while (!magnitude.empty())
+    chunks.push_back(divModSmall(magnitude, BIGINT_DECIMAL_CHUNK));
+
+  auto result = std::string(negative ? "-" : "");
+  // a chunk has 9 digits, but the compiler checks the format against the whole range of a limb
+  char buffer[11];
+
+  // the most significant chunk is not padded, all the others are
+  snprintf(buffer, sizeof(buffer), "%lu", (unsigned long)chunks.back());
+  result.append(buffer);
+
+  for (size_t i = chunks.size() - 1; i-- > 0;)
+  {
+    snprintf(buffer, sizeof(buffer), "%09lu", (unsigned long)chunks[i]);
+    result.append(buffer);
+  }
+
+  return result;
+}
+
+float64 BigInt::toFloat() const
+{
+  float64 result = 0;
+
+  for (size_t i = limbs.size(); i-- > 0;)
+    result = result * 4294967296.0 + limbs[i];
+
+  return negative ? -result : result;
+}
+
+BigInt BigInt::negated() const
+{
+  auto result = *this;
+
+  result.negative = !negative && !isZero();
+  return result;
+}
+
+BigInt BigInt::add(const BigInt& l, const BigInt& r)
+{
+  // zero has no sign, so it would bounce between add and sub forever
+  if (r.isZero())
+    return l;
+
+  if (l.isZero())
+    return r;
+
+  // different signs, this is a subtraction of magnitudes
+  if (l.negative != r.negative)
+    return sub(l, r.negated());
+
+  auto result     = l.limbs.size() >= r.limbs.size() ? l : r;
+  auto& shorter   = l.limbs.size() >= r.limbs.size() ? r : l;
+
+  result.limbs.push_back(0);
+  addInto(result.limbs.data(), result.limbs.size(), shorter.limbs.data(), shorter.limbs.size());
+  result.trim();
+
+  return result;
+}
+
+BigInt BigInt::sub(const BigInt& l, const BigInt& r)
+{
+  if (r.isZero())
+    return l;
+
+  if (l.isZero())
+    return r.negated();
+
+  // different signs, this is an addition of magnitudes
+  if (l.negative != r.negative)
+    return add(l, r.negated());
+
+  // subtracting the smaller magnitude from the bigger one, flipping the sign when needed
+  auto cmp = compareMagnitudes(l.limbs, r.limbs);
+
+  if (cmp == 0)
+    return BigInt();
+
+  auto result      = cmp > 0 ? l : r;
+  auto& subtrahend = cmp > 0 ? r : l;
+
+  subInto(result.limbs.data(), result.limbs.size(), subtrahend.limbs.data(), subtrahend.limbs.size());
+  result.negative = cmp > 0 ? l.negative : !l.negative;
+  result.trim();
+
+  return result;
+}
+
+BigInt BigInt::mul(const BigInt& l, const BigInt& r)
+{
+  auto result = BigInt();
+
+  if (l.isZero() || r.isZero())
+    return result;
+
+  result.limbs.assign(l.limbs.size() + r.limbs.size(), 0);
+  mulMagnitudes(l.limbs.data(), l.limbs.size(), r.limbs.data(), r.limbs.size(), result.limbs.data());
+
+  result.negative = l.negative != r.negative;
+  result.trim();
+
+  return result;
+}
+
+void BigInt::divMod(const BigInt& l, const BigInt& r, BigInt& quot, BigInt& rem)
+{
+  quot = BigInt();
+  rem  = BigInt();
+
+  // the dividend is smaller than the divisor
+  if (compareMagnitudes(l.limbs, r.limbs) < 0)
+  {
+    rem = l;
+    return;
+  }
+
+  if (r.limbs.size() == 1)
+  {
+    quot.limbs = l.limbs;
+
+    auto remLimb = divModSmall(quot.limbs, r.limbs[0]);
+
+    if (remLimb != 0)
+      rem.limbs.push_back(remLimb);
+  }
+  else
+    divModMagnitudes(l.limbs, r.limbs, quot.limbs, rem.limbs);
+
+  // truncated division: the quotient is negative when the signs differ, the remainder takes the dividend's sign
+  quot.negative = l.negative != r.negative;
+  rem.negative  = l.negative;
+
+  quot.trim();
+  rem.trim();
+}
\ No newline at end of file
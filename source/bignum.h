@@ -0,0 +1,86 @@
+#pragma once
+
+#include <nds.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// operands shorter than this (in limbs) are multiplied with the schoolbook algorithm,
+// longer ones are split with karatsuba, which only pays off once the recursion overhead is amortized
+#define BIGINT_KARATSUBA_THRESHOLD 24
+
+// arbitrary precision signed integer, stored as sign + magnitude.
+// limbs are 32 bits wide and little endian (limbs[0] is the least significant one),
+// so that a limb by limb product fits the native 32x32->64 multiply of the arm946e-s (umull/umlal).
+// the magnitude never has leading zero limbs, zero is represented by an empty limbs array
+class BigInt
+{
+  public: bool                  negative;
+  public: std::vector<uint32_t> limbs;
+
+  public: BigInt()
+  {
+    this->negative = false;
+    this->limbs    = std::vector<uint32_t>();
+  }
+
+  public: BigInt(int64_t value);
+
+  // parses a sequence of decimal digits (no sign)
+  public: static BigInt fromString(std::string digits);
+
+  // converts an already floored float value, returns false when it's infinite or nan
+  public: static bool fromFloat(float64 value, BigInt& result);
+
+  public: std::string toString() const;
+
+  public: float64 toFloat() const;
+
+  public: inline bool isZero() const
+  {
+    return limbs.empty();
+  }
+
+  public: inline bool fitsInt32() const
+  {
+    if (limbs.size() > 1)
+      return false;
+
+    if (limbs.empty())
+      return true;
+
+    // the negative range has one more value than the positive one
+    return limbs[0] <= (negative ? uint32_t(0x80000000) : uint32_t(0x7FFFFFFF));
+  }
+
+  // only valid when `fitsInt32()`
+  public: inline int32_t toInt32() const
+  {
+    if (limbs.empty())
+      return 0;
+
+    return negative ? int32_t(0 - limbs[0]) : int32_t(limbs[0]);
+  }
+
+  public: BigInt negated() const;
+
+  public: static BigInt add(const BigInt& l, const BigInt& r);
+
+  public: static BigInt sub(const BigInt& l, const BigInt& r);
+
+  public: static BigInt mul(const BigInt& l, const BigInt& r);
+
+  // truncated division (like c), `r` must not be zero
+  public: static void divMod(const BigInt& l, const BigInt& r, BigInt& quot, BigInt& rem);
+
+  private: inline void trim()
+  {
+    while (!limbs.empty() && limbs.back() == 0)
+      limbs.pop_back();
+
+    // there is no negative zero
+    if (limbs.empty())
+      negative = false;
+  }
+};
\ No newline at end of file
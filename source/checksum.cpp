@@ -0,0 +1,301 @@
+#include "checksum.h"
+
+#include <string.h>
+
+// the largest number of bytes whose sums can be accumulated before `b` could overflow 32 bits
+#define ADLER32_MOD  65521
+#define ADLER32_NMAX 5552
+
+static uint32_t crcTables[8][256];
+static bool     crcTablesReady = false;
+
+static void initCrcTables()
+{
+  for (uint32_t i = 0; i < 256; i++)
+  {
+    auto crc = i;
+
+    for (auto bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+
+    crcTables[0][i] = crc;
+  }
+
+  // tables[k][i] is the crc of byte i followed by k zero bytes
+  for (uint32_t i = 0; i < 256; i++)
+    for (auto k = 1; k < 8; k++)
+      crcTables[k][i] = (crcTables[k - 1][i] >> 8) ^ crcTables[0][crcTables[k - 1][i] & 0xFF];
+
+  crcTablesReady = true;
+}
+
+static inline uint32_t loadLittle32(const uint8_t* p)
+{
+  return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+static inline uint32_t loadBig32(const uint8_t* p)
+{
+  return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+}
+
+static inline uint32_t rotl(uint32_t x, uint32_t n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+
+static std::string toHex(const uint32_t* words, uint32_t count, bool bigEndian)
+{
+  static const char digits[] = "0123456789abcdef";
+
+  auto result = std::string();
+
+  for (uint32_t i = 0; i < count; i++)
+    for (auto byte = 0; byte < 4; byte++)
+    {
+      auto value = uint8_t(words[i] >> (bigEndian ? 24 - byte * 8 : byte * 8));
+
+      result += digits[value >> 4];
+      result += digits[value & 15];
+    }
+
+  return result;
+}
+
+void Crc32::update(const uint8_t* data, uint32_t length)
+{
+  if (!crcTablesReady)
+    initCrcTables();
+
+  auto c = crc;
+
+  // byte by byte up to a word boundary, so the main loop only does aligned word loads
+  while (length > 0 && (uintptr_t(data) & 3) != 0)
+  {
+    c = crcTables[0][(c ^ *data++) & 0xFF] ^ (c >> 8);
+    length--;
+  }
+
+  while (length >= 8)
+  {
+    uint32_t one, two;
+
+    memcpy(&one, data, 4);
+    memcpy(&two, data + 4, 4);
+
+    // both targets are little endian, the loads already have the byte order the tables expect
+    one ^= c;
+    c    = crcTables[7][one & 0xFF] ^ crcTables[6][(one >> 8) & 0xFF] ^ crcTables[5][(one >> 16) & 0xFF] ^ crcTables[4][one >> 24] ^
+           crcTables[3][two & 0xFF] ^ crcTables[2][(two >> 8) & 0xFF] ^ crcTables[1][(two >> 16) & 0xFF] ^ crcTables[0][two >> 24];
+
+    data   += 8;
+    length -= 8;
+  }
+
+  while (length-- > 0)
+    c = crcTables[0][(c ^ *data++) & 0xFF] ^ (c >> 8);
+
+  crc = c;
+}
+
+std::string Crc32::hexDigest()
+{
+  auto digest = ~crc;
+  return toHex(&digest, 1, true);
+}
+
+void Adler32::update(const uint8_t* data, uint32_t length)
+{
+  // the modulo is only taken once every ADLER32_NMAX bytes
+  while (length > 0)
+  {
+    auto chunk = length < ADLER32_NMAX ? length : ADLER32_NMAX;
+    length    -= chunk;
+
+    while (chunk >= 4)
+    {
+      a += data[0]; b += a;
+      a += data[1]; b += a;
+      a += data[2]; b += a;
+      a += data[3]; b += a;
+
+      data  += 4;
+      chunk -= 4;
+    }
+
+    while (chunk-- > 0)
+    {
+      a += *data++;
+      b += a;
+    }
+
+    a %= ADLER32_MOD;
+    b %= ADLER32_MOD;
+  }
+}
+
+std::string Adler32::hexDigest()
+{
+  auto digest = (b << 16) | a;
+  return toHex(&digest, 1, true);
+}
+
+void BlockHasher::update(const uint8_t* data, uint32_t length)
+{
+  totalLength += length;
+
+  // completing the pending partial block
+  if (blockLength > 0)
+  {
+    auto missing = 64 - blockLength;
+    auto copied  = length < missing ? length : missing;
+
+    memcpy(block + blockLength, data, copied);
+    blockLength += copied;
+    data        += copied;
+    length      -= copied;
+
+    if (blockLength < 64)
+      return;
+
+    compress(block);
+    blockLength = 0;
+  }
+
+  // whole blocks are compressed in place
+  while (length >= 64)
+  {
+    compress(data);
+    data   += 64;
+    length -= 64;
+  }
+
+  memcpy(block, data, length);
+  blockLength = length;
+}
+
+void BlockHasher::pad(bool bigEndianLength)
+{
+  auto bits = totalLength * 8;
+
+  uint8_t trailer[72] = { 0x80 };
+  auto    padding     = (blockLength < 56 ? 56 : 120) - blockLength;
+
+  for (auto i = 0; i < 8; i++)
+    trailer[padding + i] = uint8_t(bits >> (bigEndianLength ? 56 - i * 8 : i * 8));
+
+  update(trailer, padding + 8);
+}
+
+void Sha1::compress(const uint8_t* data)
+{
+  // a rolling window of 16 message words instead of the full 80 words schedule
+  uint32_t w[16];
+
+  for (auto i = 0; i < 16; i++)
+    w[i] = loadBig32(data + i * 4);
+
+  auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+  for (auto i = 0; i < 80; i++)
+  {
+    if (i >= 16)
+      w[i & 15] = rotl(w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w[i & 15], 1);
+
+    uint32_t f, k;
+
+    if (i < 20)
+    {
+      f = d ^ (b & (c ^ d));
+      k = 0x5A827999;
+    }
+    else if (i < 40)
+    {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1;
+    }
+    else if (i < 60)
+    {
+      f = (b & c) | (d & (b | c));
+      k = 0x8F1BBCDC;
+    }
+    else
+    {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6;
+    }
+
+    auto t = rotl(a, 5) + f + e + k + w[i & 15];
+    e      = d;
+    d      = c;
+    c      = rotl(b, 30);
+    b      = a;
+    a      = t;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+
+std::string Sha1::hexDigest()
+{
+  pad(true);
+  return toHex(state, 5, true);
+}
+
+void Md5::compress(const uint8_t* data)
+{
+  static const uint8_t shifts[4][4] = { { 7, 12, 17, 22 }, { 5, 9, 14, 20 }, { 4, 11, 16, 23 }, { 6, 10, 15, 21 } };
+
+  // floor(abs(sin(i + 1)) * 2^32)
+  static const uint32_t constants[64] = {
+    0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE, 0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+    0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE, 0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+    0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA, 0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+    0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED, 0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+    0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C, 0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+    0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05, 0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+    0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039, 0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+    0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1, 0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391,
+  };
+
+  uint32_t m[16];
+
+  for (auto i = 0; i < 16; i++)
+    m[i] = loadLittle32(data + i * 4);
+
+  auto a = state[0], b = state[1], c = state[2], d = state[3];
+
+  for (auto i = 0; i < 64; i++)
+  {
+    uint32_t f, g;
+
+    switch (i >> 4)
+    {
+      case 0:  f = d ^ (b & (c ^ d)); g = i;                break;
+      case 1:  f = c ^ (d & (b ^ c)); g = (5 * i + 1) & 15; break;
+      case 2:  f = b ^ c ^ d;         g = (3 * i + 5) & 15; break;
+      default: f = c ^ (b | ~d);      g = (7 * i) & 15;     break;
+    }
+
+    auto t = d;
+    d      = c;
+    c      = b;
+    b      = b + rotl(a + f + constants[i] + m[g], shifts[i >> 4][i & 3]);
+    a      = t;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+}
+
+std::string Md5::hexDigest()
+{
+  pad(false);
+  return toHex(state, 4, false);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <nds.h>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// streaming checksums and hashes, fed in blocks of any size through `update`.
+// they are plain c++ written for the arm946e-s (no unaligned loads, no 64 bits multiplies, few live words),
+// on the host the same loops are left to the compiler's auto vectorization
+class Hasher
+{
+  public: virtual ~Hasher() = default;
+
+  public: virtual void update(const uint8_t* data, uint32_t length) = 0;
+
+  // the digest as lowercase hex, big endian like the usual command line tools print it
+  public: virtual std::string hexDigest() = 0;
+};
+
+// crc-32 (ieee 802.3, the one of zip and png), slice-by-8: eight 256 entries tables, 8 bytes per step
+class Crc32 : public Hasher
+{
+  private: uint32_t crc = 0xFFFFFFFF;
+
+  public: void update(const uint8_t* data, uint32_t length) override;
+
+  public: std::string hexDigest() override;
+};
+
+class Adler32 : public Hasher
+{
+  private: uint32_t a = 1;
+  private: uint32_t b = 0;
+
+  public: void update(const uint8_t* data, uint32_t length) override;
+
+  public: std::string hexDigest() override;
+};
+
+// shared block buffering of sha-1 and md5, which both work on 64 bytes blocks
+class BlockHasher : public Hasher
+{
+  protected: uint8_t  block[64];
+  protected: uint32_t blockLength = 0;
+  protected: uint64_t totalLength = 0;
+
+  public: void update(const uint8_t* data, uint32_t length) override;
+
+  protected: virtual void compress(const uint8_t* block) = 0;
+
+  // appends the `0x80 0x00.. length` trailer, with the bit length in the given endianness
+  protected: void pad(bool bigEndianLength);
+};
+
+class Sha1 : public BlockHasher
+{
+  private: uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+  public: std::string hexDigest() override;
+
+  protected: void compress(const uint8_t* block) override;
+};
+
+class Md5 : public BlockHasher
+{
+  private: uint32_t state[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 };
+
+  public: std::string hexDigest() override;
+
+  protected: void compress(const uint8_t* block) override;
+};
\ No newline at end of file
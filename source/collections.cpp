@@ -0,0 +1,179 @@
+#include "collections.h"
+
+// fnv-1a, one multiply per byte and good enough spreading for short keys
+static inline uint32_t hashString(cstring_t s)
+{
+  uint32_t hash = 2166136261u;
+
+  for (; *s != '\0'; s++)
+    hash = (hash ^ uint8_t(*s)) * 16777619u;
+
+  return hash;
+}
+
+NScript::ListValue* NScript::ListValue::slice(uint32_t start, uint32_t end)
+{
+  auto result = new ListValue();
+
+  // short slices fit the inline storage, copying them is cheaper than pinning this buffer
+  if (end - start <= LIST_INLINE_CAPACITY)
+  {
+    std::copy(items + start, items + end, result->items);
+    result->length = end - start;
+
+    return result;
+  }
+
+  result->items    = items + start;
+  result->length   = end - start;
+  result->capacity = 0;
+  shared           = true;
+
+  return result;
+}
+
+void NScript::ListValue::grow(uint32_t minCapacity)
+{
+  // geometric growth keeps push amortized O(1)
+  auto newCapacity = std::max(minCapacity, std::max(capacity * 2, uint32_t(LIST_INLINE_CAPACITY * 2)));
+  auto newItems    = new Value[newCapacity];
+
+  std::copy(items, items + length, newItems);
+
+  // views keep pointing to the old buffer, so it's only released when nobody else sees it
+  if (ownsHeapItems() && !shared)
+    delete [] items;
+
+  this->items    = newItems;
+  this->capacity = newCapacity;
+  this->shared   = false;
+}
+
+NScript::Value* NScript::DictValue::get(cstring_t key)
+{
+  auto slot = findSlot(key, hashString(key));
+
+  return slot == DICT_NOT_FOUND ? nullptr : &entries[slots[slot]].value;
+}
+
+void NScript::DictValue::set(cstring_t key, Value value)
+{
+  auto hash = hashString(key);
+  auto slot = findSlot(key, hash);
+
+  // the key is already there, overwriting its value keeps the insertion order
+  if (slot != DICT_NOT_FOUND)
+  {
+    entries[slots[slot]].value = value;
+    return;
+  }
+
+  insertEntry(intern(key, hash), hash, value);
+}
+
+bool NScript::DictValue::remove(cstring_t key)
+{
+  auto slot = findSlot(key, hashString(key));
+
+  if (slot == DICT_NOT_FOUND)
+    return false;
+
+  // the slot becomes a tombstone, so that the probe sequences passing through it are not broken,
+  // the entry stays as a hole in the insertion order until the next rehash compacts it
+  entries[slots[slot]].key = nullptr;
+  slots[slot]              = DICT_DELETED_SLOT;
+  length--;
+
+  return true;
+}
+
+uint32_t NScript::DictValue::findSlot(cstring_t key, uint32_t hash)
+{
+  for (auto i = hash & slotsMask;; i = (i + 1) & slotsMask)
+  {
+    auto index = slots[i];
+
+    if (index == DICT_EMPTY_SLOT)
+      return DICT_NOT_FOUND;
+
+    if (index == DICT_DELETED_SLOT)
+      continue;
+
+    // the cached hash filters out almost all the mismatches, interned keys often match by pointer
+    auto& entry = entries[index];
+
+    if (entry.hash == hash && (entry.key == key || strcmp(entry.key, key) == 0))
+      return i;
+  }
+}
+
+void NScript::DictValue::insertEntry(cstring_t key, uint32_t hash, Value value)
+{
+  // rehashing also when removed entries pile up, since reusing deleted slots doesn't grow `usedSlots`
+  if ((usedSlots + 1) * 3 > (slotsMask + 1) * 2 || entries.size() >= 2 * length + DICT_MIN_SLOTS)
+    rehash();
+
+  auto i = hash & slotsMask;
+
+  // the key is known to be missing, so the first free slot (empty or deleted) is taken
+  while (slots[i] != DICT_EMPTY_SLOT && slots[i] != DICT_DELETED_SLOT)
+    i = (i + 1) & slotsMask;
+
+  if (slots[i] == DICT_EMPTY_SLOT)
+    usedSlots++;
+
+  slots[i] = uint32_t(entries.size());
+  entries.push_back((DictEntry) { .hash = hash, .key = key, .value = value });
+  length++;
+}
+
+void NScript::DictValue::rehash()
+{
+  // dropping the removed entries, keeping the insertion order
+  if (length != entries.size())
+    entries.erase(
+      std::remove_if(entries.begin(), entries.end(), [] (const DictEntry& e) { return e.key == nullptr; }),
+      entries.end()
+    );
+
+  // doubling until the table is at most 1/3 full, so that the next rehash is far away
+  auto slotsCount = uint32_t(DICT_MIN_SLOTS);
+
+  while (slotsCount < (length + 1) * 3)
+    slotsCount *= 2;
+
+  delete [] slots;
+
+  this->slots     = new uint32_t[slotsCount];
+  this->slotsMask = slotsCount - 1;
+  this->usedSlots = length;
+
+  std::fill(slots, slots + slotsCount, DICT_EMPTY_SLOT);
+
+  // the cached hashes make this a pass over integers only
+  for (uint32_t index = 0; index < entries.size(); index++)
+  {
+    auto i = entries[index].hash & slotsMask;
+
+    while (slots[i] != DICT_EMPTY_SLOT)
+      i = (i + 1) & slotsMask;
+
+    slots[i] = index;
+  }
+}
+
+cstring_t NScript::DictValue::intern(cstring_t key, uint32_t hash)
+{
+  // the pool is a dict itself, with no values, filled through insertEntry to not recurse in here
+  static auto pool = new DictValue();
+
+  auto slot = pool->findSlot(key, hash);
+
+  if (slot != DICT_NOT_FOUND)
+    return pool->entries[pool->slots[slot]].key;
+
+  auto owned = cstringRealloc(key);
+
+  pool->insertEntry(owned, hash, Value());
+  return owned;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "nscript.h"
+
+// lists up to this length live inside the ListValue itself, without a second allocation
+#define LIST_INLINE_CAPACITY 4
+
+// dict slots are kept at most 2/3 full, so that linear probing sequences stay short
+#define DICT_MIN_SLOTS    8
+#define DICT_EMPTY_SLOT   0xFFFFFFFF
+#define DICT_DELETED_SLOT 0xFFFFFFFE
+#define DICT_NOT_FOUND    0xFFFFFFFF
+
+namespace NScript
+{
+  // growable contiguous array of values, indexed in O(1) and appended in amortized O(1).
+  // slices are views pointing into the items of the sliced list and they only copy them when pushed to,
+  // this is safe because lists only grow at their end, so the items seen by a view never change
+  class ListValue
+  {
+    public:  Value*   items;
+    public:  uint32_t length;
+    public:  uint32_t capacity;  // 0 for views, which don't own their items
+    private: bool     shared;    // a view points into `items`, so the buffer cannot be freed when growing
+    private: Value    inlineItems[LIST_INLINE_CAPACITY];
+
+    public: ListValue()
+    {
+      this->items    = inlineItems;
+      this->length   = 0;
+      this->capacity = LIST_INLINE_CAPACITY;
+      this->shared   = false;
+    }
+
+    // `items` may point to `inlineItems`, copying would alias the other list's storage
+    public: ListValue(const ListValue&) = delete;
+
+    public: ~ListValue()
+    {
+      if (ownsHeapItems() && !shared)
+        delete [] items;
+    }
+
+    public: inline void push(Value item)
+    {
+      // a view has to copy its items first, past its end are the ones of the sliced list
+      if (length == capacity || capacity == 0)
+        grow(length + 1);
+
+      items[length++] = item;
+    }
+
+    public: inline void reserve(uint32_t count)
+    {
+      if (count > capacity)
+        grow(std::max(count, length));
+    }
+
+    // items in [start, end), both already checked to be in range
+    public: ListValue* slice(uint32_t start, uint32_t end);
+
+    private: inline bool ownsHeapItems()
+    {
+      return capacity > 0 && items != inlineItems;
+    }
+
+    private: void grow(uint32_t minCapacity);
+  };
+
+  class DictEntry
+  {
+    public: uint32_t  hash;  // cached, so that probing and rehashing never touch the key's characters
+    public: cstring_t key;   // interned, null when the entry was removed
+    public: Value     value;
+  };
+
+  // open addressing hash table with linear probing, keyed by strings.
+  // entries are stored densely in insertion order (which is also the iteration order),
+  // the slots table only holds 32 bits indices into them, so an entry costs its 4 words plus 1.5 slots
+  class DictValue
+  {
+    public:  std::vector<DictEntry> entries;
+    public:  uint32_t               length;     // live entries, `entries` also contains the removed ones
+    private: uint32_t*              slots;      // index into `entries`, DICT_EMPTY_SLOT or DICT_DELETED_SLOT
+    private: uint32_t               slotsMask;  // slots count - 1, which is always a power of 2
+    private: uint32_t               usedSlots;  // non empty slots, deleted ones included since they lengthen the probes
+
+    public: DictValue()
+    {
+      this->entries   = std::vector<DictEntry>();
+      this->length    = 0;
+      this->slots     = new uint32_t[DICT_MIN_SLOTS];
+      this->slotsMask = DICT_MIN_SLOTS - 1;
+      this->usedSlots = 0;
+
+      std::fill(slots, slots + DICT_MIN_SLOTS, DICT_EMPTY_SLOT);
+    }
+
+    public: DictValue(const DictValue&) = delete;
+
+    public: ~DictValue()
+    {
+      delete [] slots;
+    }
+
+    // lookups hash the key in place and never allocate, null when missing
+    public: Value* get(cstring_t key);
+
+    public: void set(cstring_t key, Value value);
+
+    // returns false when the key is missing
+    public: bool remove(cstring_t key);
+
+    private: uint32_t findSlot(cstring_t key, uint32_t hash);
+
+    private: void insertEntry(cstring_t key, uint32_t hash, Value value);
+
+    private: void rehash();
+
+    // every key is allocated once, equal keys of different dicts share the same string
+    private: static cstring_t intern(cstring_t key, uint32_t hash);
+  };
+}
\ No newline at end of file
@@ -1,5 +1,17 @@
 #include "console.h"
 
+void NDSConsole::processInputEvents(InputQueue* queue)
+{
+  InputEvent event;
+
+  while (queue->pop(event))
+    switch (event.kind)
+    {
+      case InputEventKind::VirtualKey: processVirtualKey(event.value);        break;
+      case InputEventKind::Buttons:    processButtons(uint32_t(event.value)); break;
+    }
+}
+
 void NDSConsole::processVirtualKey(int key)
 {
   // remapping some special virtual keyboard keys
@@ -14,11 +26,11 @@ void NDSConsole::processVirtualKey(int key)
       break;
 
     case DVK_UP:
-      moveRecentBuffer(MovingDirection2D::LeftOrUp);
+      moveCursorVertically(MovingDirection2D::LeftOrUp);
       break;
     
     case DVK_DOWN:
-      moveRecentBuffer(MovingDirection2D::RightOrDown);
+      moveCursorVertically(MovingDirection2D::RightOrDown);
       break;
 
     case DVK_BACKSPACE:
@@ -43,8 +55,35 @@ void NDSConsole::processVirtualKey(int key)
   }
 }
 
+void NDSConsole::processButtons(uint32_t buttons)
+{
+  switch (buttons)
+  {
+    case KEY_LEFT:   moveCursorIndex(MovingDirection2D::LeftOrUp);         break;
+    case KEY_RIGHT:  moveCursorIndex(MovingDirection2D::RightOrDown);      break;
+    case KEY_UP:     moveCursorVertically(MovingDirection2D::LeftOrUp);    break;
+    case KEY_DOWN:   moveCursorVertically(MovingDirection2D::RightOrDown); break;
+    case KEY_B:      removeChar();                                         break;
+    case KEY_A:      returnPrompt();                                       break;
+    case KEY_X:      scrollScreen(MovingDirection2D::LeftOrUp);            break;
+    case KEY_Y:      scrollScreen(MovingDirection2D::RightOrDown);         break;
+    case KEY_SELECT: toggleLiveDiagnostics();                              break;
+  }
+}
+
 void NDSConsole::insertChar(char c)
 {
+  // a tab would take a variable number of cells, breaking the layout of the prompt
+  if (c == '\t')
+    c = ' ';
+
+  // the cells of the prompt line have to stay addressable by an index_t
+  if (promptBuffer->length() >= INDEX_MAX - getPromptPrefixLength())
+    return;
+
+  // typing brings the view back to the prompt
+  screen->scrollToBottom();
+
   // the letter has to be added at the top of the string
   if (promptCursorIndex == promptBuffer->length())
   {
@@ -54,14 +93,16 @@ void NDSConsole::insertChar(char c)
   // the letter has to be inserted inside the string
   else
     promptBuffer->insert(promptBuffer->begin() + promptCursorIndex++, c);
-  
-  // setting the max reached prompt length whether the current prompt length is greater
-  if (promptBuffer->length() > maxReachedPromptLength)
-    maxReachedPromptLength = promptBuffer->length();
+
+  // coloring again only the tokens around the new letter
+  highlighter.update(*promptBuffer, promptCursorIndex - 1, 1);
+  promptChanged();
 }
 
 void NDSConsole::removeChar()
 {
+  screen->scrollToBottom();
+
   // when the prompt buffer is empty there's no need to remove any char
   if (promptCursorIndex == 0)
     return;
@@ -71,35 +112,28 @@ void NDSConsole::removeChar()
   {
     promptBuffer->pop_back();
     promptCursorIndex--;
-    return;
   }
-
   // the letter to remove is inside the string
-  promptBuffer->erase(promptBuffer->begin() + --promptCursorIndex);
+  else
+    promptBuffer->erase(promptBuffer->begin() + --promptCursorIndex);
+
+  highlighter.update(*promptBuffer, promptCursorIndex, -1);
+  promptChanged();
 }
 
-void NDSConsole::flushPromptBuffer(uint64_t frame, bool printCursor)
+void NDSConsole::flushPromptBuffer(uint32_t frame, bool printCursor)
 {
-  // going back at the end of the prompt prefix
-  printableConsole->cursorX = getPromptPrefix().length();
+  // going back at the end of the prompt prefix, the prompt is written again and what followed it is cut
+  output.setCursorX(getPromptPrefixLength());
+  output.write(promptBuffer->data(), highlighter.palettes.data(), promptBuffer->length());
+  output.clearToEnd();
 
-  // printing the buffer and the cursor
-  for (uint64_t i = 0; i < promptBuffer->length(); i++)
+  // the cursor goes over the char it's on, so it never moves the text around
+  if (printCursor)
   {
-    // printing the cursor when it's inside the string
-    if (i == promptCursorIndex)
-      printBlinkingCursor(frame, printCursor);
-
-    iprintf("%c", promptBuffer->at(i));
+    output.setCursorX(getPromptPrefixLength() + promptCursorIndex);
+    printBlinkingCursor(frame);
   }
-
-  // printing the cursor when is on the top of the string
-  if (promptCursorIndex == promptBuffer->length())
-    printBlinkingCursor(frame, printCursor);
-
-  // replacing the overflowed letters with spaces
-  for (uint64_t i = 0; i < maxReachedPromptLength + 1 - promptBuffer->length(); i++)
-    iprintf(" ");
 }
 
 void NDSConsole::moveCursorIndex(MovingDirection2D direction)
@@ -112,7 +146,26 @@ void NDSConsole::moveCursorIndex(MovingDirection2D direction)
   if (direction == MovingDirection2D::RightOrDown && promptCursorIndex == promptBuffer->length())
     return;
   
-  promptCursorIndex += uint64_t(direction);
+  promptCursorIndex += index_t(direction);
+}
+
+void NDSConsole::moveCursorVertically(MovingDirection2D direction)
+{
+  auto row     = getPromptRow(promptCursorIndex);
+  auto lastRow = getPromptRow(promptBuffer->length());
+
+  // the cursor is on the first or last row of the prompt
+  if ((direction == MovingDirection2D::LeftOrUp && row == 0) || (direction == MovingDirection2D::RightOrDown && row == lastRow))
+  {
+    moveRecentBuffer(direction);
+    return;
+  }
+
+  // the same column on the other row, or the nearest end of the prompt
+  if (direction == MovingDirection2D::LeftOrUp)
+    promptCursorIndex = promptCursorIndex > SCREEN_COLUMNS ? promptCursorIndex - SCREEN_COLUMNS : 0;
+  else
+    promptCursorIndex = promptCursorIndex + SCREEN_COLUMNS < promptBuffer->length() ? promptCursorIndex + SCREEN_COLUMNS : promptBuffer->length();
 }
 
 void NDSConsole::moveRecentBuffer(MovingDirection2D direction)
@@ -126,14 +179,18 @@ void NDSConsole::moveRecentBuffer(MovingDirection2D direction)
     return;
   
   // updating the recent prompts index and setting up the new prompt buffer
-  recentPromptsIndex     += uint64_t(direction);
+  recentPromptsIndex     += index_t(direction);
   this->promptBuffer      = recentPrompts[recentPromptsIndex];
   this->promptCursorIndex = promptBuffer->length();
+
+  highlighter.reset(*promptBuffer);
+  promptChanged();
 }
 
 void NDSConsole::scrollScreen(MovingDirection2D direction)
 {
-  // unimplemented yet
+  // paging back through the output, a row of the previous page stays visible
+  screen->scroll(-int32_t(direction) * (SCREEN_ROWS - 1));
 }
 
 void NDSConsole::returnPrompt()
@@ -149,11 +206,16 @@ void NDSConsole::returnPrompt()
     recentPrompts.pop_back();
   }
 
+  screen->scrollToBottom();
+  screen->clearFooter();
+
   // reprinting the current prompt buffer without the cursor
   flushPromptBuffer(1, false);
 
-  // going to the next line for the prompted command output
-  iprintf("\n");
+  // going to the next line for the prompted command output,
+  // the prompt must be on screen before what the command prints directly
+  output.write("\n", 1);
+  output.flush();
 
   try
   {
@@ -161,8 +223,12 @@ void NDSConsole::returnPrompt()
     auto result = processCommand(*promptBuffer);
 
     // when the expression returns `none` it's not shown up
-    if (result.kind != NScript::NodeKind::None)
-      iprintf("\n%s\n", result.toString().c_str());
+    if (result.kind() != NScript::NodeKind::None)
+    {
+      output.write("\n", 1);
+      result.writeTo(output);
+      output.write("\n", 1);
+    }
   }
   catch (const NScript::Error& e)
   {
@@ -173,6 +239,9 @@ void NDSConsole::returnPrompt()
   // the old one is already saved on the top of recentPrompts
   this->promptBuffer      = new std::string();
   this->promptCursorIndex = 0;
+
+  highlighter.reset(*promptBuffer);
+  promptChanged();
   
   // saving the new prompt buffer on the top of recentPrompts
   recentPromptsIndex      = recentPrompts.size();
@@ -184,36 +253,76 @@ void NDSConsole::returnPrompt()
 
 void NDSConsole::printPromptParsingError(NScript::Error e)
 {
-  auto promptLength = getPromptPrefix().length();
+  auto promptLength = getPromptPrefixLength();
 
   // padding the error underlining
-  for (uint64_t i = 0; i < promptLength + e.position.startPos; i++)
-    iprintf(" ");
-
+  output.fill(' ', promptLength + e.position.startPos);
   
   // underlining the wrong part
-  for (uint64_t i = 0; i < e.position.length(); i++)
-    iprintf("-");
+  output.fill('-', e.position.length());
   
   // printing the error message
-  iprintf("\n\nerror: ");
+  output.write("\n\nerror: ");
   for (const auto& m : e.message)
-    iprintf("%s", m.c_str());
+    output.write(m);
   
-  iprintf("\n");
+  output.write("\n", 1);
 }
 
-NScript::Node NDSConsole::processCommand(std::string command)
+void NDSConsole::toggleLiveDiagnostics()
 {
-  NScript::Parser parser(command);
-  
-  return evaluator.evaluateNode(parser.parse());
+  liveDiagnostics = !liveDiagnostics;
+  promptChanged();
 }
 
-void NDSConsole::printBlinkingCursor(uint64_t frame, bool printCursor)
+void NDSConsole::updateDiagnostics()
 {
-  if (!printCursor)
+  // an empty prompt is not an error yet
+  if (!liveDiagnostics || promptBuffer->empty() || !diagnostics.tick(*promptBuffer, highlighter.tokens))
+    return;
+
+  if (!diagnostics.hasError)
     return;
 
-  iprintf(frame % 32 <= 16 ? " " : "|");
+  // underlining the wrong part like printPromptParsingError, followed by the message
+  auto cells   = std::vector<ScreenCell>(getPromptPrefixLength() + diagnostics.errorStart, makeScreenCell(' ', 0));
+  auto palette = highlightPalettes[uint8_t(HighlightKind::Bad)];
+
+  cells.insert(cells.end(), diagnostics.errorEnd - diagnostics.errorStart, makeScreenCell('-', palette));
+  cells.push_back(makeScreenCell(' ', 0));
+
+  for (const auto& c : diagnostics.message)
+    cells.push_back(makeScreenCell(c, palette));
+
+  screen->setFooter(cells.data(), cells.size());
+}
+
+void NDSConsole::promptChanged()
+{
+  // the preview of the old prompt doesn't hold anymore
+  screen->clearFooter();
+
+  if (liveDiagnostics)
+    diagnostics.invalidate();
+}
+
+NScript::Value NDSConsole::processCommand(std::string command)
+{
+  NScript::Parser parser(command);
+
+  auto tree = parser.parse();
+
+  evaluator.compile(tree);
+  return evaluator.evaluateNode(tree);
+}
+
+void NDSConsole::printBlinkingCursor(uint32_t frame)
+{
+  // when hidden, the char under the cursor shows up again (a space past the end)
+  if (frame % 32 > 16)
+    output.write("|", 1);
+  else if (promptCursorIndex < promptBuffer->length())
+    output.write(promptBuffer->data() + promptCursorIndex, highlighter.palettes.data() + promptCursorIndex, 1);
+  else
+    output.write(" ", 1);
 }
\ No newline at end of file
@@ -7,6 +7,10 @@
 
 #include "basics.h"
 #include "nscript.h"
+#include "output.h"
+#include "highlight.h"
+#include "diagnostics.h"
+#include "input.h"
 
 enum class MovingDirection2D
 {
@@ -18,23 +22,27 @@ class NDSConsole
 {
   private: std::string*              promptBuffer;
   private: std::vector<std::string*> recentPrompts;
-  private: uint64_t                  recentPromptsIndex;
-  private: uint64_t                  promptCursorIndex;
-  private: uint64_t                  maxReachedPromptLength;
+  private: index_t                   recentPromptsIndex;
+  private: index_t                   promptCursorIndex;
   private: Keyboard*                 virtualKeyboard;
-  private: PrintConsole*             printableConsole;
+  private: TextScreen*               screen;
   private: NScript::Evaluator        evaluator;
+  private: ConsoleOutput             output;
+  private: Highlighter               highlighter;
+  private: LiveDiagnostics           diagnostics;
+  private: bool                      liveDiagnostics;
 
-  public: NDSConsole(PrintConsole* printableConsole, Keyboard* virtalKeyboard)
+  public: NDSConsole(TextScreen* screen, Keyboard* virtalKeyboard)
   {
     this->promptBuffer           = new std::string();
     this->recentPrompts          = { promptBuffer };
     this->recentPromptsIndex     = 0;
     this->promptCursorIndex      = 0;
-    this->maxReachedPromptLength = 0;
     this->virtualKeyboard        = virtualKeyboard;
-    this->printableConsole       = printableConsole;
+    this->screen                 = screen;
     this->evaluator              = NScript::Evaluator();
+    this->output                 = ConsoleOutput(screen);
+    this->liveDiagnostics        = false;
 
     keyboardShow();
   }
@@ -45,25 +53,47 @@ class NDSConsole
       delete prompt;
   }
 
+  // handles the events queued since the last call, in the order they happened
+  public: void processInputEvents(InputQueue* queue);
+
   public: void processVirtualKey(int key);
 
+  // the physical buttons pressed at one sample
+  public: void processButtons(uint32_t buttons);
+
   public: void insertChar(char c);
 
   public: void removeChar();
 
-  public: void flushPromptBuffer(uint64_t frame, bool printCursor);
+  public: void flushPromptBuffer(uint32_t frame, bool printCursor);
 
   public: void moveCursorIndex(MovingDirection2D direction);
 
   public: void moveRecentBuffer(MovingDirection2D direction);
 
+  // moves the cursor to the row above or below inside a prompt spanning many rows, from the first or last one it moves through the recent prompts
+  public: void moveCursorVertically(MovingDirection2D direction);
+
   public: void scrollScreen(MovingDirection2D direction);
 
   public: void returnPrompt();
 
+  // switches the error preview under the prompt while typing
+  public: void toggleLiveDiagnostics();
+
+  // runs the pending part of the error preview, once per frame
+  public: void updateDiagnostics();
+
   public: inline void printPromptPrefix()
   {
-    iprintf("\n%s", getPromptPrefix().c_str());
+    output.write("\n", 1);
+    output.write(getPromptPrefix());
+  }
+
+  // applies the output collected during the frame, to be called at vblank
+  public: inline void presentOutput()
+  {
+    output.flush();
   }
 
   private: inline std::string getPromptPrefix()
@@ -71,9 +101,23 @@ class NDSConsole
     return evaluator.cwd + " $ ";
   }
 
+  private: inline index_t getPromptPrefixLength()
+  {
+    return evaluator.cwd.length() + 3;
+  }
+
+  // the prompt takes a cell per char after the prefix, so its layout on the wrapped rows follows from the indexes,
+  // the cursor cell after the last char included
+  private: inline index_t getPromptRow(index_t index)
+  {
+    return (getPromptPrefixLength() + index) / SCREEN_COLUMNS;
+  }
+
   private: void printPromptParsingError(NScript::Error e);
 
-  private: NScript::Node processCommand(std::string command);
+  private: void promptChanged();
+
+  private: NScript::Value processCommand(std::string command);
 
-  private: void printBlinkingCursor(uint64_t frame, bool printCursor);
+  private: void printBlinkingCursor(uint32_t frame);
 };
\ No newline at end of file
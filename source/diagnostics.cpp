@@ -0,0 +1,303 @@
+#include "diagnostics.h"
+
+#include <string.h>
+
+// the char standing for a token in the grammar: operators are themselves, `a` identifiers, `n` none, `0` numbers,
+// `'` strings, `?` anything else and `\0` the end of the prompt
+static char symbolOf(const std::string& line, const std::vector<HighlightToken>& tokens, uint32_t index)
+{
+  if (index >= tokens.size())
+    return '\0';
+
+  switch (tokens[index].kind)
+  {
+    case HighlightKind::Plain:    return 'a';
+    case HighlightKind::Keyword:  return 'n';
+    case HighlightKind::Number:   return '0';
+    case HighlightKind::String:   return '\'';
+    case HighlightKind::Operator: return line[tokens[index].start];
+    case HighlightKind::Bad:      return '?';
+  }
+
+  return '?';
+}
+
+void LiveDiagnostics::invalidate()
+{
+  pending     = true;
+  running     = false;
+  quietFrames = 0;
+  hasError    = false;
+}
+
+bool LiveDiagnostics::tick(const std::string& line, const std::vector<HighlightToken>& tokens)
+{
+  if (!pending)
+    return false;
+
+  if (!running)
+  {
+    if (quietFrames++ < DIAGNOSTICS_DEBOUNCE_FRAMES)
+      return false;
+
+    // the whole prompt is an expression followed by its end
+    depth    = 0;
+    current  = 0;
+    hasError = false;
+    running  = true;
+
+    push(RecognizerRule::Expect, '\0');
+    push(RecognizerRule::Expression);
+
+    if (!checkToken(line, tokens))
+    {
+      running = pending = false;
+      return true;
+    }
+  }
+
+  for (auto steps = 0; steps < DIAGNOSTICS_STEPS_PER_FRAME; steps++)
+    if (!step(line, tokens))
+    {
+      running = pending = false;
+      return true;
+    }
+
+  return false;
+}
+
+bool LiveDiagnostics::step(const std::string& line, const std::vector<HighlightToken>& tokens)
+{
+  // everything was recognized
+  if (depth == 0)
+    return false;
+
+  auto frame   = stack[depth - 1];
+  auto symbol  = symbolOf(line, tokens, current);
+  auto isEnd   = current >= tokens.size();
+  auto start   = isEnd ? uint32_t(line.length()) : tokens[current].start;
+  auto end     = isEnd ? start + 1 : start + tokens[current].length;
+  auto prevEnd = current > 0 ? tokens[current - 1].start + tokens[current - 1].length : 0;
+  auto found   = isEnd ? std::string("<eof>") : line.substr(start, end - start);
+
+  switch (frame.rule)
+  {
+    case RecognizerRule::Expression:
+      depth--;
+      return push(RecognizerRule::AddTail) && push(RecognizerRule::SubExpression);
+
+    case RecognizerRule::SubExpression:
+      depth--;
+      return push(RecognizerRule::MulTail) && push(RecognizerRule::Term);
+
+    case RecognizerRule::AddTail:
+    case RecognizerRule::MulTail:
+      if (frame.rule == RecognizerRule::AddTail ? symbol != '+' && symbol != '-' : symbol != '*' && symbol != '/' && symbol != '%')
+      {
+        // with an operator, the expression is a binary one, otherwise it's its first operand
+        if (frame.kind == '?')
+          resultKind = '?';
+
+        depth--;
+        return true;
+      }
+
+      stack[depth - 1].kind = '?';
+      return advance(line, tokens) && push(frame.rule == RecognizerRule::AddTail ? RecognizerRule::SubExpression : RecognizerRule::Term);
+
+    case RecognizerRule::Term:
+      depth--;
+
+      // like the parser, the next token is lexed before the current one is looked at
+      if (!advance(line, tokens))
+        return false;
+
+      switch (symbol)
+      {
+        case 'a':
+        case '\'':
+          return push(RecognizerRule::Postfix, symbol, start);
+
+        case 'n':
+        case '0':
+          return push(RecognizerRule::Postfix, '?', start);
+
+        case '+':
+        case '-':
+          return push(RecognizerRule::Postfix, '?', start) && push(RecognizerRule::Term);
+
+        // the parenthesized expression is the term itself, `(name)(...)` is still a call
+        case '(':
+          return push(RecognizerRule::Postfix, '(', current < tokens.size() ? tokens[current].start : line.length()) && push(RecognizerRule::Expect, ')') && push(RecognizerRule::Expression);
+
+        case '[':
+        case '{':
+          return push(RecognizerRule::Postfix, '?', start) && push(RecognizerRule::Sequence, symbol == '[' ? ']' : '}', start);
+      }
+
+      return fail("unexpected token (found `" + found + "`)", start, end);
+
+    case RecognizerRule::Postfix:
+    {
+      depth--;
+
+      // a parenthesized term ends before the `)`
+      auto isGroup = frame.kind == '(';
+      auto kind    = isGroup ? resultKind : frame.kind;
+      auto termEnd = isGroup ? tokens[current - 2].start + tokens[current - 2].length : prevEnd;
+
+      if (symbol == '(')
+      {
+        if (kind != 'a' && kind != '\'')
+          return fail("expected string or identifier call name", frame.start, termEnd);
+
+        return advance(line, tokens) && push(RecognizerRule::IndexLoop, '?') && push(RecognizerRule::Sequence, ')', start);
+      }
+
+      if (symbol == '=')
+      {
+        if (kind != 'a')
+          return fail("expected an identifier when assigning", frame.start, termEnd);
+
+        return advance(line, tokens) && push(RecognizerRule::IndexLoop, '?') && push(RecognizerRule::Expression);
+      }
+
+      return push(RecognizerRule::IndexLoop, kind);
+    }
+
+    case RecognizerRule::IndexLoop:
+      if (symbol != '[')
+      {
+        resultKind = frame.kind;
+        depth--;
+        return true;
+      }
+
+      stack[depth - 1].kind = '?';
+      return advance(line, tokens) && push(RecognizerRule::IndexStart);
+
+    case RecognizerRule::IndexStart:
+      depth--;
+      return symbol == ':' ? push(RecognizerRule::IndexSlice) : push(RecognizerRule::IndexAfterStart) && push(RecognizerRule::Expression);
+
+    case RecognizerRule::IndexAfterStart:
+      depth--;
+      return symbol == ':' ? push(RecognizerRule::IndexSlice) : push(RecognizerRule::Expect, ']');
+
+    case RecognizerRule::IndexSlice:
+      depth--;
+
+      // eating `:`, the end of the slice is optional
+      if (!advance(line, tokens))
+        return false;
+
+      return symbolOf(line, tokens, current) == ']'
+        ? push(RecognizerRule::Expect, ']')
+        : push(RecognizerRule::Expect, ']') && push(RecognizerRule::Expression);
+
+    case RecognizerRule::Expect:
+      depth--;
+
+      if (symbol != frame.kind)
+        return fail(
+          "expected `" + (frame.kind == '\0' ? std::string("<eof>") : std::string(1, frame.kind)) + "` (found `" + found + "`)",
+          start, end
+        );
+
+      return advance(line, tokens);
+
+    case RecognizerRule::Sequence:
+      if (isEnd)
+        return fail(
+          frame.kind == ')' ? "unclosed call parameters list" : frame.kind == ']' ? "unclosed list" : "unclosed dict",
+          frame.start, prevEnd
+        );
+
+      if (symbol == frame.kind)
+      {
+        depth--;
+        return advance(line, tokens);
+      }
+
+      // when this is not the first element
+      if (frame.count > 0)
+      {
+        if (symbol != ',')
+          return fail("expected `,` (found `" + found + "`)", start, end);
+
+        if (!advance(line, tokens))
+          return false;
+      }
+
+      stack[depth - 1].count++;
+      return (frame.kind != '}' || push(RecognizerRule::DictValue)) && push(RecognizerRule::Expression);
+
+    case RecognizerRule::DictValue:
+      depth--;
+
+      if (symbol != ':')
+        return fail("expected `:` (found `" + found + "`)", start, end);
+
+      return advance(line, tokens) && push(RecognizerRule::Expression);
+  }
+
+  return false;
+}
+
+bool LiveDiagnostics::advance(const std::string& line, const std::vector<HighlightToken>& tokens)
+{
+  current++;
+  return checkToken(line, tokens);
+}
+
+bool LiveDiagnostics::checkToken(const std::string& line, const std::vector<HighlightToken>& tokens)
+{
+  if (current >= tokens.size())
+    return true;
+
+  auto token = tokens[current];
+  auto end   = token.start + token.length;
+  auto text  = line.substr(token.start, token.length);
+
+  // the errors the parser throws while lexing
+  if (token.kind == HighlightKind::Bad && text[0] == '\'')
+    return fail("unclosed string", token.start, line.length());
+
+  if (token.kind == HighlightKind::Bad && text[0] >= '0' && text[0] <= '9')
+  {
+    auto dots = 0;
+
+    for (const auto& c : text)
+      dots += c == '.';
+
+    if (dots > 1)
+      return fail("number cannot include more than one dot", token.start, end);
+
+    if (text.back() == '.')
+      return fail("number cannot end with a dot (correction: `" + text.substr(0, text.length() - 1) + "`)", token.start, end);
+
+    return fail("number cannot include part of identifier (correction: `" + text + " " + line[end] + "...`)", token.start, end + 1);
+  }
+
+  if (token.kind == HighlightKind::String)
+    for (uint32_t i = 1; i + 1 < token.length; i++)
+      if (text[i] == '\\')
+      {
+        if (!strchr("\\'vnt0", text[i + 1]))
+          return fail("unknown escaped char `\\" + std::string(1, text[i + 1]) + "`", token.start + i, token.start + i + 1);
+
+        i++;
+      }
+
+  return true;
+}
+
+bool LiveDiagnostics::fail(std::string message, uint32_t start, uint32_t end)
+{
+  this->hasError   = true;
+  this->message    = message;
+  this->errorStart = start;
+  this->errorEnd   = end;
+
+  return false;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <nds.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+#include "highlight.h"
+
+// the prompt is checked once it stayed unchanged for this many frames
+#define DIAGNOSTICS_DEBOUNCE_FRAMES 15
+
+// recognizer steps run in a frame (a step is one grammar rule or token), a longer check goes on in the next frames
+#define DIAGNOSTICS_STEPS_PER_FRAME 64
+
+// nesting the recognizer follows, deeper prompts are left unchecked
+#define DIAGNOSTICS_MAX_DEPTH       128
+
+enum class RecognizerRule : uint8_t
+{
+  Expression,
+  SubExpression,
+  AddTail,          // the `+ sub_expression` which follow, `kind` becomes `?` after the first
+  MulTail,          // the `* term` which follow, the same
+  Term,
+  Postfix,          // call or assignment after a term, `kind` is the term one, or `(` for a parenthesized expression
+  IndexLoop,        // `kind` is the one of the term, until it gets indexed
+  IndexStart,
+  IndexAfterStart,
+  IndexSlice,
+  Expect,           // the token `kind` (`\0` for the end of the prompt)
+  Sequence,         // call arguments, list elements or dict pairs, closed by `kind`
+  DictValue,
+};
+
+struct RecognizerFrame
+{
+  RecognizerRule rule;
+  char           kind;
+  uint16_t       count;
+  uint32_t       start;  // where the construct begins in the prompt
+};
+
+// checks the prompt against the grammar of NScript::Parser while typing, from the tokens the highlighter already has.
+// it only recognizes (no nodes, no exceptions), on a fixed stack, and stops at the first error, the one the parser would throw
+class LiveDiagnostics
+{
+  public: bool        hasError = false;
+  public: uint32_t    errorStart;
+  public: uint32_t    errorEnd;
+  public: std::string message;
+
+  private: RecognizerFrame stack[DIAGNOSTICS_MAX_DEPTH];
+  private: uint32_t        depth       = 0;
+  private: uint32_t        current     = 0;  // index of the current token
+  private: char            resultKind  = 0;  // of the last completed expression: `a` identifier, `'` string, `?` anything else
+  private: uint32_t        quietFrames = 0;
+  private: bool            pending     = false;
+  private: bool            running     = false;
+
+  // the prompt changed, the last result doesn't hold anymore
+  public: void invalidate();
+
+  // runs the debounce and up to a frame budget of the check, returns true when a new result is ready
+  public: bool tick(const std::string& line, const std::vector<HighlightToken>& tokens);
+
+  // returns false when the check is over
+  private: bool step(const std::string& line, const std::vector<HighlightToken>& tokens);
+
+  // moves to the next token, false when that token is malformed
+  private: bool advance(const std::string& line, const std::vector<HighlightToken>& tokens);
+
+  private: bool checkToken(const std::string& line, const std::vector<HighlightToken>& tokens);
+
+  private: bool fail(std::string message, uint32_t start, uint32_t end);
+
+  private: inline bool push(RecognizerRule rule, char kind = 0, uint32_t start = 0)
+  {
+    if (depth == DIAGNOSTICS_MAX_DEPTH)
+      return false;
+
+    stack[depth++] = { .rule = rule, .kind = kind, .count = 0, .start = start };
+    return true;
+  }
+};
\ No newline at end of file
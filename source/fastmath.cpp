@@ -0,0 +1,309 @@
+#include "fastmath.h"
+#include "numeric.h"
+
+#include <math.h>
+
+#define FASTMATH_SIN_TABLE_SIZE (1 << FASTMATH_SIN_TABLE_BITS)
+#define FASTMATH_LOG_TABLE_SIZE (1 << FASTMATH_LOG_TABLE_BITS)
+
+// binary angle measurement: a full turn is 2^32, so that wrapping around is free
+#define FASTMATH_RADIANS_TO_BAM 683565275.5764316
+#define FASTMATH_BAM_TO_RADIANS 1.4629180792671596e-09
+
+// beyond this the angle is reduced with fmod before being converted to 64 bits
+#define FASTMATH_MAX_UNREDUCED_ANGLE 1e9
+
+// atan(2^-i) in binary angle units
+static const uint32_t cordicAtanTable[FASTMATH_CORDIC_STEPS] = {
+  0x20000000, 0x12e4051e, 0x9fb385b, 0x51111d4, 0x28b0d43, 0x145d7e1, 0xa2f61e, 0x517c55,
+  0x28be53,   0x145f2f,   0xa2f98,   0x517cc,   0x28be6,   0x145f3,   0xa2fa,   0x517d,
+  0x28be,     0x145f,     0xa30,     0x518,     0x28c,     0x146,     0xa3,     0x51,
+  0x29,       0x14,       0xa,       0x5,
+};
+
+// all values are Q2.30, one extra entry avoids wrapping the index when interpolating.
+// the exp2 table stores 2^x - 1, so that 2^1 still fits in a signed 32 bits integer
+static int32_t sinTable[FASTMATH_SIN_TABLE_SIZE + 1];
+static int32_t log2Table[FASTMATH_LOG_TABLE_SIZE + 1];
+static int32_t exp2Table[FASTMATH_LOG_TABLE_SIZE + 1];
+static bool    tablesInitialized = false;
+
+static void initTables()
+{
+  if (tablesInitialized)
+    return;
+
+  // chebyshev recurrence sin((n+1)d) = 2cos(d)sin(nd) - sin((n-1)d), so only one sin and one cos are computed
+  auto step      = 2 * M_PI / FASTMATH_SIN_TABLE_SIZE;
+  auto twoCos    = 2 * ::cos(step);
+  float64 prev   = -::sin(step);
+  float64 cur    = 0;
+
+  for (uint32_t i = 0; i <= FASTMATH_SIN_TABLE_SIZE; i++)
+  {
+    sinTable[i] = int32_t(lround(cur * (1 << 30)));
+
+    auto next = twoCos * cur - prev;
+    prev      = cur;
+    cur       = next;
+  }
+
+  // exp2 is a geometric progression, log2 has no cheap recurrence and is paid once
+  auto    exp2Step = ::exp2(1.0 / FASTMATH_LOG_TABLE_SIZE);
+  float64 exp2Cur  = 1;
+
+  for (uint32_t i = 0; i <= FASTMATH_LOG_TABLE_SIZE; i++)
+  {
+    log2Table[i] = int32_t(lround(::log2(1 + float64(i) / FASTMATH_LOG_TABLE_SIZE) * (1 << 30)));
+    exp2Table[i] = int32_t(lround((exp2Cur - 1) * (1 << 30)));
+    exp2Cur     *= exp2Step;
+  }
+
+  tablesInitialized = true;
+}
+
+// linear interpolation between table[index] and table[index + 1], `frac` is a 16 bits fraction
+static inline int32_t interpolate(const int32_t* table, uint32_t index, uint32_t frac)
+{
+  auto a = table[index];
+  auto b = table[index + 1];
+
+  return a + int32_t(((int64_t(b) - a) * frac) >> 16);
+}
+
+static inline int32_t sinBam(uint32_t angle)
+{
+  auto index = angle >> (32 - FASTMATH_SIN_TABLE_BITS);
+  auto frac  = (angle >> (32 - FASTMATH_SIN_TABLE_BITS - 16)) & 0xFFFF;
+
+  return interpolate(sinTable, index, frac);
+}
+
+static inline uint32_t radiansToBam(float64 x)
+{
+  if (fabs(x) >= FASTMATH_MAX_UNREDUCED_ANGLE)
+    x = fmod(x, 2 * M_PI);
+
+  return uint32_t(int64_t(x * FASTMATH_RADIANS_TO_BAM));
+}
+
+// cordic in vectoring mode: rotates (x, y) onto the x axis accumulating the rotation angle
+static uint32_t atan2Bam(int32_t y, int32_t x)
+{
+  uint32_t angle = 0;
+
+  // moving to the right half plane, where cordic converges
+  if (x < 0)
+  {
+    x     = -x;
+    y     = -y;
+    angle = 0x80000000;
+  }
+
+  for (uint32_t i = 0; i < FASTMATH_CORDIC_STEPS; i++)
+  {
+    auto nx = y > 0 ? x + (y >> i) : x - (y >> i);
+    auto ny = y > 0 ? y - (x >> i) : y + (x >> i);
+
+    angle += y > 0 ? cordicAtanTable[i] : -cordicAtanTable[i];
+    x      = nx;
+    y      = ny;
+  }
+
+  return angle;
+}
+
+// log2 of a value in [1, 2) whose fraction is given in 32 bits, result is Q2.30
+static inline int32_t log2Fraction(uint32_t frac)
+{
+  return interpolate(log2Table, frac >> (32 - FASTMATH_LOG_TABLE_BITS), (frac >> (32 - FASTMATH_LOG_TABLE_BITS - 16)) & 0xFFFF);
+}
+
+// 2^f - 1 of a fraction in [0, 1) given in 32 bits, result is Q2.30
+static inline int32_t exp2Fraction(uint32_t frac)
+{
+  return interpolate(exp2Table, frac >> (32 - FASTMATH_LOG_TABLE_BITS), (frac >> (32 - FASTMATH_LOG_TABLE_BITS - 16)) & 0xFFFF);
+}
+
+float64 FastMath::sqrt(float64 x)
+{
+#ifdef FASTMATH_REFERENCE
+  return ::sqrt(x);
+#else
+  // libm gives the nan of negative inputs and keeps infinity
+  if (x <= 0 || !isFiniteFloat(x))
+    return ::sqrt(x);
+
+  // x = m * 2^e, with m being a 63 bits integer
+  int  e;
+  auto m = uint64_t(ldexp(frexp(x, &e), 63));
+
+  e -= 63;
+
+  // the exponent has to be even to be halved
+  if (e & 1)
+  {
+    m >>= 1;
+    e++;
+  }
+
+  return ldexp(float64(Numeric::sqrt64(m)), e / 2);
+#endif
+}
+
+float64 FastMath::sin(float64 x)
+{
+#ifdef FASTMATH_REFERENCE
+  return ::sin(x);
+#else
+  // infinity and nan have no angle to reduce, libm gives nan
+  if (!isFiniteFloat(x))
+    return ::sin(x);
+
+  initTables();
+  return sinBam(radiansToBam(x)) * (1.0 / (1 << 30));
+#endif
+}
+
+float64 FastMath::cos(float64 x)
+{
+#ifdef FASTMATH_REFERENCE
+  return ::cos(x);
+#else
+  if (!isFiniteFloat(x))
+    return ::cos(x);
+
+  initTables();
+  return sinBam(radiansToBam(x) + 0x40000000) * (1.0 / (1 << 30));
+#endif
+}
+
+float64 FastMath::atan2(float64 y, float64 x)
+{
+#ifdef FASTMATH_REFERENCE
+  return ::atan2(y, x);
+#else
+  // the quadrant angles of infinite operands and the nan ones come from libm
+  if (!isFiniteFloat(y) || !isFiniteFloat(x))
+    return ::atan2(y, x);
+
+  // exact results on the x axis
+  if (y == 0)
+    return x < 0 ? M_PI : 0;
+
+  // scaling both operands so that the biggest one has 30 bits, leaving room for the cordic gain (~1.65)
+  int e;
+  frexp(fmax(fabs(x), fabs(y)), &e);
+
+  auto angle = int32_t(atan2Bam(int32_t(ldexp(y, 29 - e)), int32_t(ldexp(x, 29 - e))));
+
+  // near the negative x axis the cordic error may wrap the angle across the half turn, the sign of y decides it
+  if (x < 0 && (y < 0) != (angle < 0))
+    return y < 0 ? -M_PI : M_PI;
+
+  return angle * FASTMATH_BAM_TO_RADIANS;
+#endif
+}
+
+float64 FastMath::pow(float64 x, float64 y)
+{
+#ifdef FASTMATH_REFERENCE
+  return ::pow(x, y);
+#else
+  // infinite and nan operands are left to libm, converting them to integers below would be undefined
+  if (!isFiniteFloat(x) || !isFiniteFloat(y))
+    return ::pow(x, y);
+
+  // integer exponents are computed by squaring, which is exact and needs log2(y) multiplications
+  if (y == floor(y) && fabs(y) <= INT32_MAX)
+  {
+    auto    exponent = uint32_t(fabs(y));
+    float64 result   = 1;
+
+    for (auto base = x; exponent != 0; exponent >>= 1, base *= base)
+      if (exponent & 1)
+        result *= base;
+
+    return y < 0 ? 1 / result : result;
+  }
+
+  // a negative base with a fractional exponent has no real result
+  if (x <= 0)
+    return ::pow(x, y);
+
+  initTables();
+
+  // log2(x) = e + log2(m), with m in [1, 2)
+  int  e;
+  auto m        = frexp(x, &e) * 2;
+  auto log2m    = log2Fraction(uint32_t(ldexp(m - 1, 32))) * (1.0 / (1 << 30));
+  auto exponent = y * (e - 1 + log2m);
+
+  // the result would be over the float64 range anyway, letting libm produce inf or 0
+  if (fabs(exponent) >= 1024)
+    return ::pow(x, y);
+
+  // 2^exponent = 2^n * 2^f, with f in [0, 1)
+  auto n = floor(exponent);
+
+  return ldexp(1 + exp2Fraction(uint32_t(ldexp(exponent - n, 32))) * (1.0 / (1 << 30)), int(n));
+#endif
+}
+
+// runs `fast` and `reference` over the same inputs, tracking the max absolute error and the time of both
+template<typename F, typename R> static void benchmarkFunction(cstring_t name, uint32_t samples, F fast, R reference)
+{
+  float64          maxError = 0;
+  volatile float64 sink     = 0;
+
+  for (uint32_t i = 0; i < samples; i++)
+  {
+    auto f = fast(i);
+    auto r = reference(i);
+
+    // the error is relative when the expected value is greater than 1
+    maxError = fmax(maxError, fabs(f - r) / fmax(1, fabs(r)));
+  }
+
+  auto fastTimer = Stopwatch();
+
+  for (uint32_t i = 0; i < samples; i++)
+    sink += fast(i);
+
+  auto fastUsec       = fastTimer.elapsedUsec();
+  auto referenceTimer = Stopwatch();
+
+  for (uint32_t i = 0; i < samples; i++)
+    sink += reference(i);
+
+  auto referenceUsec = referenceTimer.elapsedUsec();
+
+  printf("%-6s err %.2e  fast %luus  libm %luus\n", name, maxError, (unsigned long)fastUsec, (unsigned long)referenceUsec);
+}
+
+void FastMath::benchmark(uint32_t samples)
+{
+  initTables();
+
+  // inputs spread over the ranges the functions are usually called with
+  auto angle = [samples] (uint32_t i) { return (float64(i) / samples - 0.5) * 8 * M_PI; };
+  auto value = [samples] (uint32_t i) { return float64(i) / samples * 1000 + 0.001; };
+
+  benchmarkFunction("sqrt", samples, [&] (uint32_t i) { return FastMath::sqrt(value(i)); }, [&] (uint32_t i) { return ::sqrt(value(i)); });
+  benchmarkFunction("sin", samples, [&] (uint32_t i) { return FastMath::sin(angle(i)); }, [&] (uint32_t i) { return ::sin(angle(i)); });
+  benchmarkFunction("cos", samples, [&] (uint32_t i) { return FastMath::cos(angle(i)); }, [&] (uint32_t i) { return ::cos(angle(i)); });
+
+  benchmarkFunction(
+    "atan2", samples,
+    [&] (uint32_t i) { return FastMath::atan2(value(i) - 500, value(samples - 1 - i) - 500); },
+    [&] (uint32_t i) { return ::atan2(value(i) - 500, value(samples - 1 - i) - 500); }
+  );
+
+  benchmarkFunction(
+    "pow", samples,
+    [&] (uint32_t i) { return FastMath::pow(value(i) / 100, 2.5); },
+    [&] (uint32_t i) { return ::pow(value(i) / 100, 2.5); }
+  );
+
+  fflush(stdout);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <nds.h>
+
+#include "basics.h"
+
+// the arm946e-s has no fpu, so every libm call goes through newlib's soft-float routines.
+// these replacements work in fixed point on lookup tables and only touch float64 to convert the input and the output.
+// defining FASTMATH_REFERENCE routes every function to libm, to check the accuracy of the scripts against it
+namespace FastMath
+{
+  // entries of the sine table over a full turn, and of the log2/exp2 tables over one octave
+  #define FASTMATH_SIN_TABLE_BITS  10
+  #define FASTMATH_LOG_TABLE_BITS  10
+  #define FASTMATH_CORDIC_STEPS    28
+
+  // relative error below 2^-30 (the mantissa is reduced to 62 bits and rooted on the square root unit)
+  float64 sqrt(float64 x);
+
+  // absolute error below 5e-6 (linear interpolation between 1024 samples per turn, h^2/8 with h = 2pi/1024)
+  float64 sin(float64 x);
+
+  // same table and error bound of `sin`, shifted by a quarter of turn
+  float64 cos(float64 x);
+
+  // absolute error below 1e-7 radians (28 cordic vectoring steps on 30 bits operands)
+  float64 atan2(float64 y, float64 x);
+
+  // exact (up to float64 rounding) for integer exponents,
+  // otherwise exp2(y * log2(x)) on tables, with relative error below 6e-7 * (1 + |y * log2(x)|)
+  float64 pow(float64 x, float64 y);
+
+  // compares every function against libm over `samples` inputs, printing max error and timings
+  void benchmark(uint32_t samples);
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "grep.h"
+
+#include <string.h>
+
+// needles up to this length are searched by scanning for their first byte with memchr (word at a time in newlib),
+// horspool shifts would rarely be longer than that anyway
+#define GREP_MEMCHR_MAX_NEEDLE 3
+
+static uint32_t countNewlines(const char* begin, const char* end)
+{
+  auto count = uint32_t(0);
+
+  while ((begin = (const char*)memchr(begin, '\n', end - begin)))
+  {
+    count++;
+    begin++;
+  }
+
+  return count;
+}
+
+LiteralSearcher::LiteralSearcher(std::string needle)
+{
+  this->needle = needle;
+
+  auto length = needle.length();
+
+  for (auto& shift : skip)
+    shift = length;
+
+  for (uint32_t i = 0; i + 1 < length; i++)
+    skip[uint8_t(needle[i])] = length - 1 - i;
+}
+
+const char* LiteralSearcher::search(const char* begin, const char* end)
+{
+  auto length = needle.length();
+  auto first  = needle[0];
+
+  if (length <= GREP_MEMCHR_MAX_NEEDLE)
+  {
+    while (size_t(end - begin) >= length)
+    {
+      auto candidate = (const char*)memchr(begin, first, end - begin - length + 1);
+
+      if (candidate == nullptr)
+        return nullptr;
+
+      if (memcmp(candidate + 1, needle.c_str() + 1, length - 1) == 0)
+        return candidate;
+
+      begin = candidate + 1;
+    }
+
+    return nullptr;
+  }
+
+  auto last = needle[length - 1];
+
+  while (size_t(end - begin) >= length)
+  {
+    auto c = begin[length - 1];
+
+    if (c == last && begin[0] == first && memcmp(begin + 1, needle.c_str() + 1, length - 2) == 0)
+      return begin;
+
+    begin += skip[uint8_t(c)];
+  }
+
+  return nullptr;
+}
+
+Grep::Grep(std::string pattern, Regex* regex)
+{
+  this->literal = isLiteralPattern(pattern) ? new LiteralSearcher(pattern) : nullptr;
+  this->regex   = literal ? nullptr : regex;
+  this->buffer  = new char[GREP_BUFFER_SIZE];
+}
+
+Grep::~Grep()
+{
+  delete literal;
+  delete[] buffer;
+}
+
+bool Grep::isLiteralPattern(std::string pattern)
+{
+  return !pattern.empty() && pattern.find_first_of(".[]()|*+?^$\\\n") == std::string::npos;
+}
+
+uint32_t Grep::searchFile(FILE* file, std::function<void(uint32_t, const char*, uint32_t)> onMatch)
+{
+  // the blocks are already as large as stdio's buffer would be, so it only adds a copy
+  setvbuf(file, nullptr, _IONBF, 0);
+
+  auto matches    = uint32_t(0);
+  auto lineNumber = uint32_t(1);
+  auto carried    = uint32_t(0);
+
+  while (true)
+  {
+    auto read = fread(buffer + carried, 1, std::min(GREP_BLOCK_SIZE, GREP_BUFFER_SIZE - int(carried)), file);
+    auto end  = buffer + carried + read;
+
+    if (read == 0)
+    {
+      // the last line without a trailing `\n`
+      if (carried > 0)
+        matches += searchLines(buffer, end, lineNumber, onMatch);
+
+      return matches;
+    }
+
+    // the unfinished line stays in the buffer, unless it already fills it
+    auto linesEnd = end;
+
+    while (linesEnd > buffer && linesEnd[-1] != '\n')
+      linesEnd--;
+
+    if (linesEnd == buffer && end == buffer + GREP_BUFFER_SIZE)
+      linesEnd = end;
+
+    matches += searchLines(buffer, linesEnd, lineNumber, onMatch);
+    carried  = end - linesEnd;
+
+    memmove(buffer, linesEnd, carried);
+  }
+}
+
+uint32_t Grep::searchLines(const char* begin, const char* end, uint32_t& lineNumber, std::function<void(uint32_t, const char*, uint32_t)>& onMatch)
+{
+  auto matches = uint32_t(0);
+
+  if (literal)
+  {
+    // searching the whole region at once, lines are only delimited around the occurrences
+    auto counted = begin;
+
+    while (auto found = literal->search(begin, end))
+    {
+      auto lineStart = found;
+
+      while (lineStart > begin && lineStart[-1] != '\n')
+        lineStart--;
+
+      auto lineEnd = (const char*)memchr(found, '\n', end - found);
+      lineEnd      = lineEnd ? lineEnd : end;
+
+      lineNumber += countNewlines(counted, lineStart);
+      counted     = lineStart;
+
+      onMatch(lineNumber, lineStart, lineEnd - lineStart);
+      matches++;
+
+      if (lineEnd == end)
+        break;
+
+      begin = lineEnd + 1;
+    }
+
+    lineNumber += countNewlines(counted, end);
+    return matches;
+  }
+
+  while (begin < end)
+  {
+    auto lineEnd = (const char*)memchr(begin, '\n', end - begin);
+    lineEnd      = lineEnd ? lineEnd : end;
+
+    if (regex->search(begin, lineEnd - begin))
+    {
+      onMatch(lineNumber, begin, lineEnd - begin);
+      matches++;
+    }
+
+    if (lineEnd < end)
+      lineNumber++;
+
+    begin = lineEnd + 1;
+  }
+
+  return matches;
+}
\ No newline at end of file
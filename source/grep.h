@@ -0,0 +1,49 @@
+#pragma once
+
+#include <nds.h>
+#include <stdio.h>
+#include <c++/12.1.0/string>
+#include <c++/12.1.0/functional>
+
+#include "basics.h"
+#include "regex.h"
+
+// files are read in blocks of this size into a buffer twice as large, so the unfinished line of a block
+// is carried to the next one without ever holding the whole file, lines longer than the buffer are split
+#define GREP_BLOCK_SIZE  (32 * 1024)
+#define GREP_BUFFER_SIZE (2 * GREP_BLOCK_SIZE)
+
+// substring search for patterns without regex metacharacters
+class LiteralSearcher
+{
+  public:  std::string needle;
+  private: uint32_t    skip[256];  // horspool shift for the byte under the needle's last position
+
+  public: LiteralSearcher(std::string needle);
+
+  // first occurrence in [begin, end) or null
+  public: const char* search(const char* begin, const char* end);
+};
+
+// matching lines of a file, through a literal searcher when the pattern allows it, otherwise through a regex
+class Grep
+{
+  private: Regex*           regex;
+  private: LiteralSearcher* literal;
+  private: char*            buffer;
+
+  // `regex` is only used when the pattern is not a literal, and it's not owned
+  public: Grep(std::string pattern, Regex* regex);
+
+  public: Grep(const Grep&) = delete;
+
+  public: ~Grep();
+
+  public: static bool isLiteralPattern(std::string pattern);
+
+  // calls `onMatch(lineNumber, line, lineLength)` for each matching line, returns the matches count
+  public: uint32_t searchFile(FILE* file, std::function<void(uint32_t, const char*, uint32_t)> onMatch);
+
+  // searches the complete lines in [begin, end), `lineNumber` is the number of the line at `begin` and gets updated
+  private: uint32_t searchLines(const char* begin, const char* end, uint32_t& lineNumber, std::function<void(uint32_t, const char*, uint32_t)>& onMatch);
+};
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "hexdump.h"
+
+#include <string.h>
+
+// the two hex digits of each byte value, so a byte is encoded with one lookup and a 2 bytes copy
+static char hexPairs[256 * 2];
+static bool hexPairsReady = false;
+
+static void initHexPairs()
+{
+  static const char digits[] = "0123456789abcdef";
+
+  for (auto i = 0; i < 256; i++)
+  {
+    hexPairs[i * 2]     = digits[i >> 4];
+    hexPairs[i * 2 + 1] = digits[i & 15];
+  }
+
+  hexPairsReady = true;
+}
+
+uint32_t HexDump::formatRow(char* out, uint64_t offset, const uint8_t* bytes, uint32_t count)
+{
+  if (!hexPairsReady)
+    initHexPairs();
+
+  auto start = out;
+
+  // the offset with at least 4 digits, more only when needed
+  auto digits = 4;
+
+  while (digits < 16 && (offset >> (digits * 4)) != 0)
+    digits += 2;
+
+  for (auto i = digits - 1; i >= 0; i--)
+    *out++ = "0123456789abcdef"[(offset >> (i * 4)) & 15];
+
+  // the hex column, grouped by 4 bytes and padded when the row is incomplete
+  for (uint32_t i = 0; i < HEXDUMP_BYTES_PER_ROW; i++)
+  {
+    if (i % 4 == 0)
+      *out++ = ' ';
+
+    if (i < count)
+      memcpy(out, hexPairs + bytes[i] * 2, 2);
+    else
+      memset(out, ' ', 2);
+
+    out += 2;
+  }
+
+  *out++ = ' ';
+
+  // non printable bytes as dots
+  for (uint32_t i = 0; i < count; i++)
+    *out++ = bytes[i] >= 0x20 && bytes[i] < 0x7F ? char(bytes[i]) : '.';
+
+  *out++ = '\n';
+  return out - start;
+}
\ No newline at end of file
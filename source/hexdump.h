@@ -0,0 +1,18 @@
+#pragma once
+
+#include <nds.h>
+
+#include "basics.h"
+
+// rows look like `0010 48656c6c 6f2c2077 Hello, w`, which fits the 32 columns console while the offset has 4 digits
+#define HEXDUMP_BYTES_PER_ROW 8
+#define HEXDUMP_ROW_CAPACITY  48
+
+// the range is read in chunks of this size, and the rows of a chunk are written at once
+#define HEXDUMP_CHUNK_SIZE    512
+
+namespace HexDump
+{
+  // writes the row of up to HEXDUMP_BYTES_PER_ROW `bytes` at `offset` into `out`, returns its length (`\n` included)
+  uint32_t formatRow(char* out, uint64_t offset, const uint8_t* bytes, uint32_t count);
+}
\ No newline at end of file
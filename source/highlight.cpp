@@ -0,0 +1,140 @@
+#include "highlight.h"
+
+#include <string.h>
+
+static inline bool isWhitespace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n';
+}
+
+static inline bool isAlpha(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static inline bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+static inline bool isIdentifierChar(char c)
+{
+  return isAlpha(c) || isDigit(c) || c == '_';
+}
+
+void Highlighter::reset(const std::string& line)
+{
+  auto none = std::vector<HighlightToken>();
+
+  tokens.clear();
+  palettes.assign(line.length(), highlightPalettes[uint8_t(HighlightKind::Plain)]);
+  lexedTokens = 0;
+
+  relex(line, 0, none, 0);
+}
+
+void Highlighter::update(const std::string& line, uint32_t at, int32_t delta)
+{
+  // the palettes move along with the chars
+  if (delta > 0)
+    palettes.insert(palettes.begin() + at, delta, highlightPalettes[uint8_t(HighlightKind::Plain)]);
+  else
+    palettes.erase(palettes.begin() + at, palettes.begin() + at - delta);
+
+  // the first token which contains or touches the edit, the ones before are kept as they are
+  auto first = uint32_t(0);
+
+  while (first < tokens.size() && tokens[first].start + tokens[first].length < at)
+    first++;
+
+  auto start = first < tokens.size() && tokens[first].start < at ? tokens[first].start : at;
+  auto old   = std::vector<HighlightToken>(tokens.begin() + first, tokens.end());
+  auto reuse = uint32_t(0);
+
+  // only the tokens after the edited chars can be reused, moved by the edit
+  while (reuse < old.size() && old[reuse].start < at + (delta < 0 ? -delta : 0))
+    reuse++;
+
+  for (auto i = reuse; i < old.size(); i++)
+    old[i].start += delta;
+
+  tokens.resize(first);
+  lexedTokens = 0;
+
+  reuse = relex(line, start, old, reuse);
+  tokens.insert(tokens.end(), old.begin() + reuse, old.end());
+}
+
+uint32_t Highlighter::relex(const std::string& line, uint32_t start, std::vector<HighlightToken>& old, uint32_t reuse)
+{
+  auto s      = line.data();
+  auto length = uint32_t(line.length());
+  auto plain  = highlightPalettes[uint8_t(HighlightKind::Plain)];
+
+  for (auto position = start; true;)
+  {
+    for (; position < length && isWhitespace(s[position]); position++)
+      palettes[position] = plain;
+
+    if (position == length)
+      return old.size();
+
+    auto token = lexToken(s, length, position);
+    lexedTokens++;
+
+    // the old tokens this one went past can't match anymore
+    while (reuse < old.size() && old[reuse].start < token.start)
+      reuse++;
+
+    // the stream is in sync again, the rest of the old tokens and their palettes are still right
+    if (reuse < old.size() && old[reuse] == token)
+      return reuse;
+
+    tokens.push_back(token);
+    memset(palettes.data() + token.start, highlightPalettes[uint8_t(token.kind)], token.length);
+
+    position = token.start + token.length;
+  }
+}
+
+HighlightToken Highlighter::lexToken(const char* s, uint32_t length, uint32_t start)
+{
+  auto c    = s[start];
+  auto end  = start + 1;
+  auto kind = HighlightKind::Bad;
+
+  if (isAlpha(c))
+  {
+    while (end < length && isIdentifierChar(s[end]))
+      end++;
+
+    kind = end - start == 4 && memcmp(s + start, "none", 4) == 0 ? HighlightKind::Keyword : HighlightKind::Plain;
+  }
+  else if (isDigit(c))
+  {
+    auto dots = 0;
+
+    for (; end < length && (isDigit(s[end]) || s[end] == '.'); end++)
+      dots += s[end] == '.';
+
+    // the same numbers the parser refuses: 1.2.3, 2. and 123abc
+    auto malformed = dots > 1 || s[end - 1] == '.' || (end < length && isIdentifierChar(s[end]));
+    kind           = malformed ? HighlightKind::Bad : HighlightKind::Number;
+  }
+  else if (c == '\'')
+  {
+    // until a `'` which is not escaped
+    while (end < length && (s[end] != '\'' || (s[end - 1] == '\\' && s[end - 2] != '\\')))
+      end++;
+
+    if (end < length)
+    {
+      end++;
+      kind = HighlightKind::String;
+    }
+  }
+  else if (c != '\0' && strchr("+-*/%(),=[]:{}", c) != nullptr)
+    kind = HighlightKind::Operator;
+
+  return { .start = start, .length = end - start, .kind = kind };
+}
\ No newline at end of file
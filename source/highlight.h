@@ -0,0 +1,64 @@
+#pragma once
+
+#include <nds.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+#include "screen.h"
+
+// the token classes of the prompt, which follow the lexing rules of NScript::Parser without throwing
+enum class HighlightKind : uint8_t
+{
+  Plain,     // identifiers
+  Keyword,
+  Number,
+  String,
+  Operator,
+  Bad,       // chars out of the language, malformed numbers and unclosed strings
+};
+
+// palette of each kind, among the ansi colors libnds sets up (bright ones, from 8)
+static const uint8_t highlightPalettes[] =
+{
+  SCREEN_CURRENT_PALETTE,  // plain
+  13,                      // keyword, magenta
+  11,                      // number, yellow
+  10,                      // string, green
+  14,                      // operator, cyan
+  9,                       // bad, red
+};
+
+struct HighlightToken
+{
+  uint32_t      start;
+  uint32_t      length;
+  HighlightKind kind;
+
+  inline bool operator==(const HighlightToken& other) const
+  {
+    return start == other.start && length == other.length && kind == other.kind;
+  }
+};
+
+// the tokens of the prompt line and the palette of each of its chars, kept up to date across edits:
+// only the tokens from the edited one on are lexed again, until one equals an old token (moved by the edit)
+class Highlighter
+{
+  public: std::vector<HighlightToken> tokens;
+  public: std::vector<uint8_t>        palettes;
+  public: uint32_t                    lexedTokens = 0;  // by the last update, the rest was reused
+
+  // lexes the whole line, when it's replaced by another one
+  public: void reset(const std::string& line);
+
+  // after `delta` chars were inserted at `at` (or removed from it, when negative)
+  public: void update(const std::string& line, uint32_t at, int32_t delta);
+
+  // the token starting at `start`, which is not a whitespace
+  private: static HighlightToken lexToken(const char* s, uint32_t length, uint32_t start);
+
+  // lexes from `start`, until a token equals the old one at `reuse` (already moved) or the line ends,
+  // returns the index of that old token (or `old.size()`)
+  private: uint32_t relex(const std::string& line, uint32_t start, std::vector<HighlightToken>& old, uint32_t reuse);
+};
\ No newline at end of file
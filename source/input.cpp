@@ -0,0 +1,53 @@
+#include "input.h"
+
+static InputQueue*       pollQueue = nullptr;
+static volatile uint32_t pollTick  = 0;
+
+#ifdef ARM9
+// runs at INPUT_POLL_HZ even while a command keeps the main loop busy, so nothing typed meanwhile is lost
+static void pollInput()
+{
+  auto tick = pollTick++;
+
+  // keyboardUpdate reads the touch state scanKeys just took
+  scanKeys();
+
+  auto key     = keyboardUpdate();
+  auto buttons = keysDown();
+
+  if (key != NOKEY)
+    pollQueue->push({ .tick = tick, .kind = InputEventKind::VirtualKey, .value = key });
+
+  if (buttons != 0)
+    pollQueue->push({ .tick = tick, .kind = InputEventKind::Buttons, .value = int32_t(buttons) });
+}
+#endif
+
+void Input::startPolling(InputQueue* queue)
+{
+  pollQueue = queue;
+
+#ifdef ARM9
+  timerStart(INPUT_POLL_TIMER, ClockDivider_1024, TIMER_FREQ_1024(INPUT_POLL_HZ), pollInput);
+#endif
+}
+
+void Input::stopPolling()
+{
+#ifdef ARM9
+  timerStop(INPUT_POLL_TIMER);
+#endif
+
+  pollQueue = nullptr;
+}
+
+void Input::feedText(InputQueue* queue, const char* text)
+{
+  for (; *text != '\0'; text++)
+    queue->push({ .tick = pollTick++, .kind = InputEventKind::VirtualKey, .value = *text });
+}
+
+void Input::feedButtons(InputQueue* queue, uint32_t buttons)
+{
+  queue->push({ .tick = pollTick++, .kind = InputEventKind::Buttons, .value = int32_t(buttons) });
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <nds.h>
+
+#include "basics.h"
+
+// events the queue holds, a power of two so the indexes wrap with a mask
+#define INPUT_QUEUE_CAPACITY 128
+
+// how many times a second the keys are sampled, twice a frame so short taps between two frames are seen too
+#define INPUT_POLL_HZ        120
+
+// the hardware timer which samples the keys, timers 0 and 1 are taken by cpuStartTiming
+#define INPUT_POLL_TIMER     2
+
+enum class InputEventKind : uint8_t
+{
+  VirtualKey,  // `value` is the key returned by keyboardUpdate
+  Buttons,     // `value` is the mask of the buttons pressed at that sample, as keysDown returns it
+};
+
+struct InputEvent
+{
+  uint32_t       tick;   // the sample it was seen at, one every 1/INPUT_POLL_HZ seconds
+  InputEventKind kind;
+  int32_t        value;
+};
+
+// single producer (the timer interrupt) and single consumer (the main loop) ring of input events, without locks:
+// each index is written by one side only, and published after the event it covers is in place
+class InputQueue
+{
+  private: InputEvent events[INPUT_QUEUE_CAPACITY];
+  private: uint32_t   head    = 0;  // next event to be pushed, written by the producer
+  private: uint32_t   tail    = 0;  // next event to be popped, written by the consumer
+  public:  uint32_t   dropped = 0;  // events lost because the queue was full, written by the producer
+
+  // producer side, false when the queue is full
+  public: inline bool push(const InputEvent& event)
+  {
+    auto h = head;
+
+    if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) == INPUT_QUEUE_CAPACITY)
+    {
+      dropped++;
+      return false;
+    }
+
+    events[h & (INPUT_QUEUE_CAPACITY - 1)] = event;
+    __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // consumer side, false when the queue is empty
+  public: inline bool pop(InputEvent& event)
+  {
+    auto t = tail;
+
+    if (__atomic_load_n(&head, __ATOMIC_ACQUIRE) == t)
+      return false;
+
+    event = events[t & (INPUT_QUEUE_CAPACITY - 1)];
+    __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  public: inline uint32_t size()
+  {
+    return __atomic_load_n(&head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+  }
+};
+
+namespace Input
+{
+  // starts sampling the virtual keyboard and the buttons into `queue` from the timer interrupt,
+  // from then on keyboardUpdate and scanKeys belong to the interrupt and must not be called elsewhere
+  void startPolling(InputQueue* queue);
+
+  void stopPolling();
+
+  // stand-in producer for hosts without the interrupt: pushes `text` as virtual keys, a sample apart
+  void feedText(InputQueue* queue, const char* text);
+
+  // the same for a mask of buttons
+  void feedButtons(InputQueue* queue, uint32_t buttons);
+}
\ No newline at end of file
@@ -0,0 +1,421 @@
+#include "lz.h"
+#include "transfer.h"
+
+#include <string.h>
+
+#define LZ_HALF_BUFFER_SIZE (TRANSFER_BUFFER_SIZE / 2)
+#define LZ_NO_POSITION      0xFFFFFFFF
+
+// reads a file a block at a time into the input half of the transfer buffer
+class LzReader
+{
+  public: FILE*    file;
+  public: uint8_t* buffer;
+  public: uint32_t position = 0;
+  public: uint32_t length   = 0;
+
+  public: inline bool next(uint8_t& c)
+  {
+    if (position == length)
+    {
+      length   = fread(buffer, 1, LZ_HALF_BUFFER_SIZE, file);
+      position = 0;
+
+      if (length == 0)
+        return false;
+    }
+
+    c = buffer[position++];
+    return true;
+  }
+};
+
+// collects bytes into the output half of the transfer buffer and writes it when full
+class LzWriter
+{
+  public: FILE*    file;
+  public: uint8_t* buffer;
+  public: uint32_t length  = 0;
+  public: uint32_t flushed = 0;  // bytes at the start of `buffer` which are already in the file
+  public: uint64_t written = 0;
+  public: bool     failed  = false;
+
+  // keeps the last `keep` bytes in the buffer, to be referenced by the next ones
+  public: void flush(uint32_t keep)
+  {
+    auto count = length - flushed;
+
+    if (fwrite(buffer + flushed, 1, count, file) != count)
+      failed = true;
+
+    written += count;
+    keep     = keep < length ? keep : length;
+
+    memmove(buffer, buffer + length - keep, keep);
+    length  = keep;
+    flushed = keep;
+  }
+};
+
+static inline uint32_t hashPrefix(const uint8_t* p)
+{
+  return ((uint32_t(p[0]) << 16 | uint32_t(p[1]) << 8 | p[2]) * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+bool Lz::compress(FILE* in, FILE* out, uint32_t inputSize, LzFormat format, uint64_t& outputBytes, std::string& error)
+{
+  if (format == LzFormat::Lz10 && inputSize > LZ10_MAX_SIZE)
+  {
+    error = "lz10 can't store more than 16 MB";
+    return false;
+  }
+
+  // the chains hold absolute positions into the input, `prev` is indexed by position modulo the window
+  static uint32_t head[1 << LZ_HASH_BITS];
+  static uint32_t prev[LZ_WINDOW_SIZE];
+
+  for (auto& position : head)
+    position = LZ_NO_POSITION;
+
+  auto buffer   = (uint8_t*)Transfer::getBuffer();
+
+  if (!buffer)
+  {
+    error = "out of memory";
+    return false;
+  }
+
+  auto writer   = LzWriter { .file = out, .buffer = buffer + LZ_HALF_BUFFER_SIZE };
+  auto maxMatch = uint32_t(format == LzFormat::Lz10 ? LZ10_MAX_MATCH : LZ11_MAX_MATCH);
+
+  // input positions [base, base + filled) are in the input half
+  auto base     = uint32_t(0);
+  auto filled   = uint32_t(fread(buffer, 1, LZ_HALF_BUFFER_SIZE, in));
+  auto position = uint32_t(0);
+
+  // the header, lz11 stores sizes over 24 bits (or zero) in 4 more bytes, leaving the 24 bits field to zero
+  auto extended = format == LzFormat::Lz11 && (inputSize == 0 || inputSize > LZ10_MAX_SIZE);
+  auto header   = uint32_t(format) | (extended ? 0 : inputSize << 8);
+
+  for (auto i = 0; i < 4; i++)
+    writer.buffer[writer.length++] = uint8_t(header >> (i * 8));
+
+  if (extended)
+    for (auto i = 0; i < 4; i++)
+      writer.buffer[writer.length++] = uint8_t(inputSize >> (i * 8));
+
+  auto insert = [&] (uint32_t at)
+  {
+    auto h                          = hashPrefix(buffer + at - base);
+    prev[at & (LZ_WINDOW_SIZE - 1)] = head[h];
+    head[h]                         = at;
+  };
+
+  // sliding the input when a whole match could cross its end, keeping the window behind `position`
+  auto refill = [&] ()
+  {
+    if (position + maxMatch > base + filled && !feof(in))
+    {
+      auto keep = position - base > LZ_WINDOW_SIZE ? position - LZ_WINDOW_SIZE : base;
+
+      memmove(buffer, buffer + (keep - base), base + filled - keep);
+      filled -= keep - base;
+      base    = keep;
+      filled += fread(buffer + filled, 1, LZ_HALF_BUFFER_SIZE - filled, in);
+    }
+
+    return position < base + filled;
+  };
+
+  while (refill())
+  {
+    // a group is at most a flags byte and 8 tokens of 4 bytes
+    if (writer.length + 33 > LZ_HALF_BUFFER_SIZE)
+      writer.flush(0);
+
+    auto flagsIndex = writer.length++;
+    auto flags      = uint8_t(0);
+
+    writer.buffer[flagsIndex] = 0;
+
+    for (auto token = 0; token < 8 && refill(); token++)
+    {
+      auto available = base + filled - position;
+      auto limit     = available < maxMatch ? available : maxMatch;
+      auto bestLen   = uint32_t(0);
+      auto bestDisp  = uint32_t(0);
+
+      if (available >= LZ_MIN_MATCH)
+      {
+        auto current   = buffer + position - base;
+        auto candidate = head[hashPrefix(current)];
+
+        for (auto chain = 0; chain < LZ_MAX_CHAIN && candidate != LZ_NO_POSITION && position - candidate <= LZ_WINDOW_SIZE; chain++)
+        {
+          auto past = buffer + candidate - base;
+
+          // a longer match must at least agree on the byte after the current best
+          if (past[bestLen] == current[bestLen])
+          {
+            auto length = uint32_t(0);
+
+            while (length < limit && past[length] == current[length])
+              length++;
+
+            if (length > bestLen)
+            {
+              bestLen  = length;
+              bestDisp = position - candidate;
+
+              if (length == limit)
+                break;
+            }
+          }
+
+          // entries overwritten in the ring would point forward, ending the chain
+          auto next = prev[candidate & (LZ_WINDOW_SIZE - 1)];
+
+          if (next >= candidate)
+            break;
+
+          candidate = next;
+        }
+      }
+
+      if (bestLen < LZ_MIN_MATCH)
+      {
+        writer.buffer[writer.length++] = buffer[position - base];
+
+        if (available >= LZ_MIN_MATCH)
+          insert(position);
+
+        position++;
+        continue;
+      }
+
+      flags |= 0x80 >> token;
+
+      auto disp = bestDisp - 1;
+
+      if (format == LzFormat::Lz10)
+      {
+        writer.buffer[writer.length++] = uint8_t((bestLen - 3) << 4 | disp >> 8);
+        writer.buffer[writer.length++] = uint8_t(disp);
+      }
+      else if (bestLen <= 0x10)
+      {
+        writer.buffer[writer.length++] = uint8_t((bestLen - 1) << 4 | disp >> 8);
+        writer.buffer[writer.length++] = uint8_t(disp);
+      }
+      else if (bestLen <= 0x110)
+      {
+        auto length = bestLen - 0x11;
+
+        writer.buffer[writer.length++] = uint8_t(length >> 4);
+        writer.buffer[writer.length++] = uint8_t(length << 4 | disp >> 8);
+        writer.buffer[writer.length++] = uint8_t(disp);
+      }
+      else
+      {
+        auto length = bestLen - 0x111;
+
+        writer.buffer[writer.length++] = uint8_t(0x10 | length >> 12);
+        writer.buffer[writer.length++] = uint8_t(length >> 4);
+        writer.buffer[writer.length++] = uint8_t(length << 4 | disp >> 8);
+        writer.buffer[writer.length++] = uint8_t(disp);
+      }
+
+      // every position of the match enters the chains, later matches can start anywhere in it
+      for (auto end = position + bestLen; position < end; position++)
+        if (base + filled - position >= LZ_MIN_MATCH)
+          insert(position);
+    }
+
+    writer.buffer[flagsIndex] = flags;
+  }
+
+  // padded to 4 bytes, as the bios reads words
+  while ((writer.written + writer.length) % 4 != 0)
+    writer.buffer[writer.length++] = 0;
+
+  writer.flush(0);
+
+  if (writer.failed || ferror(in) || position != inputSize)
+  {
+    error = "unable to transfer the data";
+    return false;
+  }
+
+  outputBytes = writer.written;
+  return true;
+}
+
+bool Lz::decompress(FILE* in, FILE* out, uint64_t& outputBytes, std::string& error)
+{
+  auto buffer = (uint8_t*)Transfer::getBuffer();
+
+  if (!buffer)
+  {
+    error = "out of memory";
+    return false;
+  }
+
+  auto reader = LzReader { .file = in, .buffer = buffer };
+  auto writer = LzWriter { .file = out, .buffer = buffer + LZ_HALF_BUFFER_SIZE };
+
+  uint8_t header[4];
+
+  for (auto& c : header)
+    if (!reader.next(c))
+    {
+      error = "missing lz header";
+      return false;
+    }
+
+  auto format = header[0];
+  auto size   = uint32_t(header[1]) | uint32_t(header[2]) << 8 | uint32_t(header[3]) << 16;
+
+  if (format != uint8_t(LzFormat::Lz10) && format != uint8_t(LzFormat::Lz11))
+  {
+    error = "not lz10 or lz11 data";
+    return false;
+  }
+
+  if (format == uint8_t(LzFormat::Lz11) && size == 0)
+    for (auto i = 0; i < 4; i++)
+    {
+      uint8_t c = 0;
+      reader.next(c);
+      size |= uint32_t(c) << (i * 8);
+    }
+
+#ifdef ARM9
+  // small lz10 files fit both halves at once, then the bios does the whole job
+  if (format == uint8_t(LzFormat::Lz10) && size <= LZ_HALF_BUFFER_SIZE && reader.length < LZ_HALF_BUFFER_SIZE && feof(in))
+  {
+    swiDecompressLZSSWram(buffer, writer.buffer);
+
+    outputBytes = fwrite(writer.buffer, 1, size, out);
+    return outputBytes == size;
+  }
+#endif
+
+  // `produced` counts all the decompressed bytes, the writer only keeps the last window of them
+  auto produced  = uint32_t(0);
+  auto truncated = false;
+
+  while (produced < size && !truncated)
+  {
+    uint8_t flags;
+
+    if (!reader.next(flags))
+      break;
+
+    for (auto token = 0; token < 8 && produced < size; token++, flags <<= 1)
+    {
+      // the window stays in the buffer, any reference reaches back at most LZ_WINDOW_SIZE bytes
+      if (writer.length == LZ_HALF_BUFFER_SIZE)
+        writer.flush(LZ_WINDOW_SIZE);
+
+      uint8_t b1, b2;
+
+      if (!(flags & 0x80))
+      {
+        if (!reader.next(b1))
+        {
+          truncated = true;
+          break;
+        }
+
+        writer.buffer[writer.length++] = b1;
+        produced++;
+        continue;
+      }
+
+      if (!reader.next(b1) || !reader.next(b2))
+      {
+        truncated = true;
+        break;
+      }
+
+      uint32_t length, disp;
+
+      if (format == uint8_t(LzFormat::Lz10))
+      {
+        length = (b1 >> 4) + 3;
+        disp   = ((b1 & 0xF) << 8 | b2) + 1;
+      }
+      else if (b1 >> 4 >= 2)
+      {
+        length = (b1 >> 4) + 1;
+        disp   = ((b1 & 0xF) << 8 | b2) + 1;
+      }
+      else
+      {
+        uint8_t b3, b4 = 0;
+
+        if (!reader.next(b3) || (b1 >> 4 == 1 && !reader.next(b4)))
+        {
+          truncated = true;
+          break;
+        }
+
+        if (b1 >> 4 == 0)
+        {
+          length = ((b1 & 0xF) << 4 | b2 >> 4) + 0x11;
+          disp   = ((b2 & 0xF) << 8 | b3) + 1;
+        }
+        else
+        {
+          length = ((b1 & 0xF) << 12 | b2 << 4 | b3 >> 4) + 0x111;
+          disp   = ((b3 & 0xF) << 8 | b4) + 1;
+        }
+      }
+
+      if (disp > produced)
+      {
+        error = "corrupted lz data (reference before the start)";
+        return false;
+      }
+
+      length = length < size - produced ? length : size - produced;
+
+      // in chunks, since long lz11 references can be larger than the room left in the buffer
+      while (length > 0)
+      {
+        if (writer.length == LZ_HALF_BUFFER_SIZE)
+          writer.flush(LZ_WINDOW_SIZE);
+
+        auto room   = LZ_HALF_BUFFER_SIZE - writer.length;
+        auto chunk  = length < room ? length : room;
+        auto target = writer.buffer + writer.length;
+        auto source = target - disp;
+
+        // byte by byte, the reference may overlap the bytes it produces
+        for (uint32_t i = 0; i < chunk; i++)
+          target[i] = source[i];
+
+        writer.length += chunk;
+        produced      += chunk;
+        length        -= chunk;
+      }
+    }
+  }
+
+  writer.flush(0);
+
+  if (produced < size)
+  {
+    error = "truncated lz data";
+    return false;
+  }
+
+  if (writer.failed)
+  {
+    error = "unable to write the data";
+    return false;
+  }
+
+  outputBytes = writer.written;
+  return true;
+}
\ No newline at end of file
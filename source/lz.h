@@ -0,0 +1,37 @@
+#pragma once
+
+#include <nds.h>
+#include <stdio.h>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// the formats of the ds bios and of nitro's tools: a 4 bytes header (type and decompressed size),
+// then groups of 8 tokens led by a flags byte, each token is either a literal byte or a back reference
+// into the previous 4096 bytes. lz10 references are 3..18 bytes long, lz11 ones 3..65808
+#define LZ_WINDOW_SIZE  4096
+#define LZ_MIN_MATCH    3
+#define LZ10_MAX_MATCH  18
+#define LZ10_MAX_SIZE   0xFFFFFF
+
+// lz11 could encode references up to 65808 bytes, longer runs just take more tokens
+#define LZ11_MAX_MATCH  4096
+
+// hash chains over 3 bytes prefixes, each lookup visits at most LZ_MAX_CHAIN older positions
+#define LZ_HASH_BITS    13
+#define LZ_MAX_CHAIN    32
+
+enum class LzFormat : uint8_t
+{
+  Lz10 = 0x10,
+  Lz11 = 0x11,
+};
+
+// both directions stream through the two halves of the transfer buffer (input and output),
+// and return false with a message in `error` on failure, `outputBytes` is the size written to `out`
+namespace Lz
+{
+  bool compress(FILE* in, FILE* out, uint32_t inputSize, LzFormat format, uint64_t& outputBytes, std::string& error);
+
+  bool decompress(FILE* in, FILE* out, uint64_t& outputBytes, std::string& error);
+}
\ No newline at end of file
@@ -34,42 +34,35 @@ int main()
     panic("fat not initialized correctly");
 #endif
 
-  NDSConsole console(&printConsole, &virtualKeyboard);
+  // the console text is drawn through a shadow of the screen, only the changed cells reach vram
+  VramScreenBackend screenBackend(&printConsole);
+  TextScreen        screen(&screenBackend);
+
+  screen.capture(&printConsole);
+
+  NDSConsole console(&screen, &virtualKeyboard);
 
   iprintf("Nintendo DS Console ARM9\n");
   console.printPromptPrefix();
+
+  // from here the keys are only read by the interrupt, which queues them for the loop
+  static InputQueue inputQueue;
+  Input::startPolling(&inputQueue);
  
-  for (uint64_t frame = 0; true; frame++)
+  for (uint32_t frame = 0; true; frame++)
   {
-    // reading the pressed letter
-    auto keyboardKey = keyboardUpdate();
-
-    // when virtual key is pressed
-    if (keyboardKey != NOKEY)
-      console.processVirtualKey(keyboardKey);
-    
-    // updating the key state
-    scanKeys();
-
-    // getting the last key state
-    auto buttonKey = keysDown();
-
-    // processing the physical button keys
-    switch (buttonKey)
-    {
-      case KEY_LEFT:  console.moveCursorIndex(MovingDirection2D::LeftOrUp);     break;
-      case KEY_RIGHT: console.moveCursorIndex(MovingDirection2D::RightOrDown);  break;
-      case KEY_UP:    console.moveRecentBuffer(MovingDirection2D::LeftOrUp);    break;
-      case KEY_DOWN:  console.moveRecentBuffer(MovingDirection2D::RightOrDown); break;
-      case KEY_B:     console.removeChar();                                     break;
-      case KEY_A:     console.returnPrompt();                                   break;
-      case KEY_X:     console.scrollScreen(MovingDirection2D::LeftOrUp);        break;
-      case KEY_Y:     console.scrollScreen(MovingDirection2D::RightOrDown);     break;
-    }
+    // the keys pressed since the last frame, sampled by the timer interrupt even while a command was running
+    console.processInputEvents(&inputQueue);
+
+    // checking the prompt while typing, within a frame budget
+    console.updateDiagnostics();
 
     // printing the prompt
     console.flushPromptBuffer(frame, true);
     swiWaitForVBlank();
+
+    // drawing the frame output during the vblank
+    console.presentOutput();
   }
 
   return 0;
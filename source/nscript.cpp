@@ -1,36 +1,183 @@
 #include "nscript.h"
+#include "collections.h"
+
+#include <math.h>
 
 std::string NScript::Node::toString()
 {
-  std::string temp;
+  auto sink = StringSink();
+
+  writeTo(sink);
+  return sink.result;
+}
+
+std::string NScript::Value::toString() const
+{
+  auto sink = StringSink();
+
+  writeTo(sink);
+  return sink.result;
+}
+
+void NScript::Value::writeTo(OutputSink& sink) const
+{
+  toNode(Position()).writeTo(sink);
+}
+
+void NScript::Node::writeTo(OutputSink& sink)
+{
+  auto writeSequence = [&sink] (const Node* nodes, index_t count)
+  {
+    for (index_t i = 0; i < count; i++)
+    {
+      // when this is not the first element
+      if (i > 0)
+        sink.write(", ", 2);
+
+      Node(nodes[i]).writeTo(sink);
+    }
+  };
+
+  auto writeValues = [&sink] (const Value* values, index_t count)
+  {
+    for (index_t i = 0; i < count; i++)
+    {
+      if (i > 0)
+        sink.write(", ", 2);
+
+      values[i].writeTo(sink);
+    }
+  };
 
   switch (kind)
   {
-    case NodeKind::Num:         return cutTrailingZeros(std::to_string(value.num));
-    case NodeKind::String:      return "'" + Parser::escapedToEscapes(value.str) + "'";
-    case NodeKind::Bin:         return value.bin->left.toString() + " " + value.bin->op.toString() + " " + value.bin->right.toString();
-    case NodeKind::Una:         return value.una->op.toString() + value.una->term.toString();
-    case NodeKind::Assign:      return value.assign->name.toString() + " = " + value.assign->expr.toString();
+    case NodeKind::Num:         sink.write(cutTrailingZeros(std::to_string(value.num))); return;
+    case NodeKind::Int:         sink.write(std::to_string(value.integer));                return;
+    case NodeKind::BigInt:      sink.write(value.bigint->toString());                     return;
+
+    case NodeKind::String:
+      sink.write("'", 1);
+      Parser::writeEscapes(sink, value.str, strlen(value.str));
+      sink.write("'", 1);
+      return;
+
+    case NodeKind::Bin:
+      value.bin->left.writeTo(sink);
+      sink.write(" ", 1);
+      value.bin->op.writeTo(sink);
+      sink.write(" ", 1);
+      value.bin->right.writeTo(sink);
+      return;
+
+    case NodeKind::Una:
+      value.una->op.writeTo(sink);
+      value.una->term.writeTo(sink);
+      return;
+
+    case NodeKind::Assign:
+      value.assign->name.writeTo(sink);
+      sink.write(" = ", 3);
+      value.assign->expr.writeTo(sink);
+      return;
 
     case NodeKind::Call:
-      return value.call->name.toString() + "(" + joinArray<Node>(", ", value.call->args, [] (Node arg) { return arg.toString(); }) + ")";
+      value.call->name.writeTo(sink);
+      sink.write("(", 1);
+      writeSequence(value.call->args.data(), value.call->args.size());
+      sink.write(")", 1);
+      return;
+
+    case NodeKind::ListLiteral:
+      sink.write("[", 1);
+      writeSequence(value.listLiteral->elements.data(), value.listLiteral->elements.size());
+      sink.write("]", 1);
+      return;
+
+    case NodeKind::List:
+      sink.write("[", 1);
+      writeValues(value.list->items, value.list->length);
+      sink.write("]", 1);
+      return;
+
+    case NodeKind::DictLiteral:
+      sink.write("{", 1);
+
+      for (index_t i = 0; i < value.dictLiteral->keys.size(); i++)
+      {
+        if (i > 0)
+          sink.write(", ", 2);
+
+        value.dictLiteral->keys[i].writeTo(sink);
+        sink.write(": ", 2);
+        value.dictLiteral->values[i].writeTo(sink);
+      }
+
+      sink.write("}", 1);
+      return;
+
+    case NodeKind::Dict:
+    {
+      auto first = true;
+
+      sink.write("{", 1);
+
+      for (const auto& entry : value.dict->entries)
+        if (entry.key != nullptr)
+        {
+          sink.write(first ? "'" : ", '");
+          Parser::writeEscapes(sink, entry.key, strlen(entry.key));
+          sink.write("': ", 3);
+          entry.value.writeTo(sink);
+
+          first = false;
+        }
+
+      sink.write("}", 1);
+      return;
+    }
+
+    case NodeKind::Index:
+      value.index->expr.writeTo(sink);
+      sink.write("[", 1);
+
+      if (!value.index->isSlice)
+        value.index->start.writeTo(sink);
+      else
+      {
+        if (value.index->start.kind != NodeKind::None)
+          value.index->start.writeTo(sink);
+
+        sink.write(":", 1);
+
+        if (value.index->end.kind != NodeKind::None)
+          value.index->end.writeTo(sink);
+      }
+
+      sink.write("]", 1);
+      return;
 
     case NodeKind::Plus:
     case NodeKind::Minus:
     case NodeKind::Star:
     case NodeKind::Slash:
+    case NodeKind::Percent:
     case NodeKind::LPar:
     case NodeKind::RPar:
     case NodeKind::Comma:
     case NodeKind::Eq:
+    case NodeKind::LBrack:
+    case NodeKind::RBrack:
+    case NodeKind::Colon:
+    case NodeKind::LBrace:
+    case NodeKind::RBrace:
     case NodeKind::Bad:
-    case NodeKind::None:
-    case NodeKind::Identifier:  return value.str;
-    case NodeKind::Eof:         return "<eof>";
+    case NodeKind::Identifier:  sink.write(value.str);            return;
+    case NodeKind::None:        sink.write("none", 4);            return;
+    case NodeKind::Variable:    sink.write(value.variable->name); return;
+    case NodeKind::Eof:         sink.write("<eof>");              return;
   }
 
-  panic("unimplemented Node::toString() for some NodeKind");
-  return nullptr;
+  panic("unimplemented Node::writeTo() for some NodeKind");
 }
 
 NScript::Node NScript::Parser::nextToken()
@@ -51,7 +198,7 @@ NScript::Node NScript::Parser::nextToken()
     t = collectNumToken();
   else if (c == '\'')
     t = collectStringToken();
-  else if (arrayContains({'+', '-', '*', '/', '(', ')', ',', '='}, c))
+  else if (arrayContains({'+', '-', '*', '/', '%', '(', ')', ',', '=', '[', ']', ':', '{', '}'}, c))
     t = Node(NodeKind(c), (NodeValue) { .str = cstringRealloc(std::string(1, c).c_str()) }, curPos());
   else
     t = Node::bad(cstringRealloc(std::string(1, c).c_str()), curPos());
@@ -101,10 +248,6 @@ NScript::Node NScript::Parser::collectNumToken()
       pos
     );
   
-  auto value = (NodeValue) {
-    .num = atof(seq.c_str())
-  };
-
   // when the next char is an identifier, the user wrote something like 123hello or 123_
   if (!eof(+1) && isIdentifierChar(curChar(+1), false))
     throw Error(
@@ -112,7 +255,13 @@ NScript::Node NScript::Parser::collectNumToken()
       Position(pos.startPos, curPos(+1).endPos)
     );
 
-  return Node(NodeKind::Num, value, pos);
+  // numbers without a dot are integers, up to 9 digits they always fit in the immediate representation
+  if (countOccurrences(seq, '.') == 0)
+    return seq.length() <= 9
+      ? Node(NodeKind::Int, (NodeValue) { .integer = int32_t(atol(seq.c_str())) }, pos)
+      : Node::integer(BigInt::fromString(seq), pos);
+
+  return Node(NodeKind::Num, (NodeValue) { .num = atof(seq.c_str()) }, pos);
 }
 
 NScript::Node NScript::Parser::convertToKeywordWhenPossible(Node token)
@@ -181,6 +330,8 @@ NScript::Node NScript::Parser::expectTerm()
     // simple token
     case NodeKind::Identifier:
     case NodeKind::Num:
+    case NodeKind::Int:
+    case NodeKind::BigInt:
     case NodeKind::String:
     case NodeKind::None:
       term = prevToken;
@@ -198,6 +349,14 @@ NScript::Node NScript::Parser::expectTerm()
       term = expectExpression();
       expectTokenAndAdvance(NodeKind::RPar);
       break;
+
+    case NodeKind::LBrack:
+      term = collectListNode();
+      break;
+
+    case NodeKind::LBrace:
+      term = collectDictNode();
+      break;
     
     default:
       throw Error({"unexpected token (found `", prevToken.toString(), "`)"}, prevToken.pos);
@@ -207,10 +366,92 @@ NScript::Node NScript::Parser::expectTerm()
     term = collectCallNode(term);
   else if (curToken.kind == NodeKind::Eq)
     term = collectAssignNode(term);
+
+  // indexing can be chained, like `x[0][1:]`
+  while (curToken.kind == NodeKind::LBrack)
+    term = collectIndexNode(term);
   
   return term;
 }
 
+NScript::Node NScript::Parser::collectListNode()
+{
+  // the first `[` was already eaten by expectTerm
+  auto startPos = prevToken.pos.startPos;
+  auto elements = std::vector<Node>();
+
+  while (true)
+  {
+    if (eofToken())
+      throw Error({"unclosed list"}, Position(startPos, prevToken.pos.endPos));
+
+    if (curToken.kind == NodeKind::RBrack)
+    {
+      // eating last `]`
+      advance();
+      return Node(NodeKind::ListLiteral, (NodeValue) { .listLiteral = new ListNode(elements) }, Position(startPos, prevToken.pos.endPos));
+    }
+
+    // when this is not the first element
+    if (elements.size() > 0)
+      expectTokenAndAdvance(NodeKind::Comma);
+
+    elements.push_back(expectExpression());
+  }
+}
+
+NScript::Node NScript::Parser::collectDictNode()
+{
+  // the first `{` was already eaten by expectTerm
+  auto startPos = prevToken.pos.startPos;
+  auto keys     = std::vector<Node>();
+  auto values   = std::vector<Node>();
+
+  while (true)
+  {
+    if (eofToken())
+      throw Error({"unclosed dict"}, Position(startPos, prevToken.pos.endPos));
+
+    if (curToken.kind == NodeKind::RBrace)
+    {
+      // eating last `}`
+      advance();
+      return Node(NodeKind::DictLiteral, (NodeValue) { .dictLiteral = new DictNode(keys, values) }, Position(startPos, prevToken.pos.endPos));
+    }
+
+    // when this is not the first pair
+    if (keys.size() > 0)
+      expectTokenAndAdvance(NodeKind::Comma);
+
+    keys.push_back(expectExpression());
+    expectTokenAndAdvance(NodeKind::Colon);
+    values.push_back(expectExpression());
+  }
+}
+
+NScript::Node NScript::Parser::collectIndexNode(Node expr)
+{
+  // eating `[`
+  advance();
+
+  auto start   = curToken.kind == NodeKind::Colon ? Node::none(curToken.pos) : expectExpression();
+  auto end     = Node::none(curToken.pos);
+  auto isSlice = curToken.kind == NodeKind::Colon;
+
+  if (isSlice)
+  {
+    // eating `:`
+    advance();
+
+    if (curToken.kind != NodeKind::RBrack)
+      end = expectExpression();
+  }
+
+  expectTokenAndAdvance(NodeKind::RBrack);
+
+  return Node(NodeKind::Index, (NodeValue) { .index = new IndexNode(expr, start, end, isSlice) }, Position(expr.pos.startPos, prevToken.pos.endPos));
+}
+
 NScript::Node NScript::Parser::collectAssignNode(Node name)
 {
   if (name.kind != NodeKind::Identifier)
@@ -258,10 +499,11 @@ std::string NScript::Parser::escapesToEscaped(std::string s, Position pos)
 {
   std::string t;
 
-  for (uint64_t i = 0; i < s.length(); i++)
+  for (index_t i = 0; i < s.length(); i++)
     if (s[i] == '\\')
     {
-      t.push_back(escapeChar(s[i + 1], Position(pos.startPos + i, pos.startPos + i + 1)));
+      // the contents start after the opening `'`, the backslash is underlined as in the live diagnostics
+      t.push_back(escapeChar(s[i + 1], Position(pos.startPos + 1 + i, pos.startPos + 2 + i)));
 
       // skipping the escape code
       i++;
@@ -272,126 +514,401 @@ std::string NScript::Parser::escapesToEscaped(std::string s, Position pos)
   return t;
 }
 
-NScript::Node NScript::Evaluator::expectType(Node node, NodeKind type)
+NScript::Value NScript::Evaluator::expectType(Value value, NodeKind type, Position pos)
 {
-  if (node.kind != type)
-    throw Error({"expected a value with type `", Node::kindToString(type), "` (found `", Node::kindToString(node.kind), "`)"}, node.pos);
+  if (value.kind() != type)
+    throw Error({"expected a value with type `", Node::kindToString(type), "` (found `", Node::kindToString(value.kind()), "`)"}, pos);
   
-  return node;
+  return value;
+}
+
+NScript::Value NScript::Evaluator::expectNumeric(Value value, Position pos)
+{
+  if (!Node::isNumericKind(value.kind()))
+    throw Error({"expected a numeric value (found `", Node::kindToString(value.kind()), "`)"}, pos);
+
+  return value;
+}
+
+float64 NScript::Evaluator::expectNumericAndGetFloat(Value value, Position pos)
+{
+  return promoteNumeric(expectNumeric(value, pos), NodeKind::Num).asNum();
 }
 
-void NScript::Evaluator::expectArgsCount(CallNode call, uint64_t count)
+void NScript::Evaluator::expectArgsCount(CallNode call, index_t count)
 {
   if (call.args.size() != count)
     throw Error({"expected `", std::to_string(count), "` args (found `", std::to_string(call.args.size()), "`)"}, call.name.pos);
 }
 
-NScript::Node NScript::Evaluator::builtinFloor(CallNode call)
+NScript::Value NScript::Evaluator::builtinFloor(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  auto arg = call.args[0];
+
+  // floor(a / b) between integers is a floored division on the hardware divider, without going through floats
+  if (arg.kind == NodeKind::Bin && arg.value.bin->op.kind == NodeKind::Slash)
+  {
+    auto bin   = arg.value.bin;
+    auto left  = evaluateNode(bin->left);
+    auto right = evaluateNode(bin->right);
+
+    if (left.kind() == NodeKind::Int && right.kind() == NodeKind::Int && right.asInt() != 0 && right.asInt() != -1)
+      return Value::integer(Numeric::floorDiv32(left.asInt(), right.asInt()));
+
+    return builtinFloorValue(evaluateBinValues(*bin, left, right), arg.pos);
+  }
+
+  return builtinFloorValue(evaluateNode(arg), arg.pos);
+}
+
+NScript::Value NScript::Evaluator::builtinFloorValue(Value value, Position pos)
+{
+  auto expr = expectNumeric(value, pos);
+
+  // integers are already floored
+  if (expr.kind() != NodeKind::Num)
+    return expr;
+
+  if (!isFiniteFloat(expr.asNum()))
+    throw Error({"cannot floor a non finite number"}, pos);
+
+  auto floored = floor(expr.asNum());
+  auto big     = BigInt();
+
+  // the floored value becomes an integer, a big one when it overflows 32 bits
+  if (floored >= INT32_MIN && floored <= INT32_MAX)
+    return Value::integer(int32_t(floored));
+
+  BigInt::fromFloat(floored, big);
+  return Value::integer(big);
+}
+
+NScript::Value NScript::Evaluator::builtinSqrt(CallNode call)
 {
   expectArgsCount(call, 1);
 
-  // truncating the float value
-  auto expr = expectType(evaluateNode(call.args[0]), NodeKind::Num);
-  expr.value.num = uint64_t(expr.value.num);
+  auto arg = call.args[0];
+  auto x   = expectNumericAndGetFloat(evaluateNode(arg), arg.pos);
+
+  if (x < 0)
+    throw Error({"cannot compute the square root of a negative number"}, arg.pos);
+
+  return Value::num(FastMath::sqrt(x));
+}
+
+NScript::Value NScript::Evaluator::builtinSin(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  return Value::num(FastMath::sin(expectNumericAndGetFloat(evaluateNode(call.args[0]), call.args[0].pos)));
+}
+
+NScript::Value NScript::Evaluator::builtinCos(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  return Value::num(FastMath::cos(expectNumericAndGetFloat(evaluateNode(call.args[0]), call.args[0].pos)));
+}
+
+NScript::Value NScript::Evaluator::builtinAtan2(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto y = expectNumericAndGetFloat(evaluateNode(call.args[0]), call.args[0].pos);
+  auto x = expectNumericAndGetFloat(evaluateNode(call.args[1]), call.args[1].pos);
+
+  return Value::num(FastMath::atan2(y, x));
+}
+
+NScript::Value NScript::Evaluator::builtinPow(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto base     = expectNumeric(evaluateNode(call.args[0]), call.args[0].pos);
+  auto exponent = expectNumeric(evaluateNode(call.args[1]), call.args[1].pos);
+
+  // an integer raised to a non negative integer stays exact, squaring big integers
+  if (base.kind() != NodeKind::Num && exponent.kind() == NodeKind::Int && exponent.asInt() >= 0)
+  {
+    auto result = BigInt(1);
+    auto square = base.kind() == NodeKind::Int ? BigInt(base.asInt()) : *base.asBigInt();
+
+    for (auto e = uint32_t(exponent.asInt()); e != 0; e >>= 1)
+    {
+      if (e & 1)
+        result = BigInt::mul(result, square);
+
+      // the last square would be thrown away
+      if (e > 1)
+        square = BigInt::mul(square, square);
+    }
+
+    return Value::integer(result);
+  }
+
+  auto x = expectNumericAndGetFloat(base, call.args[0].pos);
+  auto y = expectNumericAndGetFloat(exponent, call.args[1].pos);
 
-  return expr;
+  if (x < 0 && y != floor(y))
+    throw Error({"cannot raise a negative number to a fractional power"}, call.args[0].pos);
+
+  if (x == 0 && y < 0)
+    throw Error({"cannot raise 0 to a negative power"}, call.args[0].pos);
+
+  return Value::num(FastMath::pow(x, y));
+}
+
+void NScript::Evaluator::builtinMathBench(CallNode call)
+{
+  expectArgsCount(call, 0);
+  FastMath::benchmark(10000);
 }
 
 void NScript::Evaluator::builtinPrint(CallNode call)
 {
-  // printing all arguments without separation and flushing
+  auto sink = ConsoleSink();
+
+  // printing the values of all arguments without separation and flushing
   for (auto arg : call.args)
-    iprintf("%s", arg.toString().c_str());
+    evaluateNode(arg).writeTo(sink);
   
   fflush(stdout);
 }
 
-NScript::Node NScript::Evaluator::evaluateCallProcess(CallNode call, Position pos)
+NScript::Value NScript::Evaluator::evaluateCallProcess(CallNode call)
 {
-  auto processPath = cstringRealloc(getFullPath(expectNonEmptyStringAndGetString(call.name), true).c_str());
+  auto processPath = cstringRealloc(getFullPath(expectNonEmptyStringAndGetString(Value::fromNode(call.name), call.name.pos), true).c_str());
   auto processArgv = new char*[call.args.size() + 2];
 
   processArgv[0] = (char*)processPath;
 
-  for (uint64_t i = 1; i < call.args.size(); i++)
-    processArgv[i] = (char*)cstringRealloc(expectStringLengthAndGetString(evaluateNode(call.args[i]), [] (uint64_t l) { return true; }).c_str());
+  for (index_t i = 1; i < call.args.size(); i++)
+    processArgv[i] = (char*)cstringRealloc(expectStringLengthAndGetString(evaluateNode(call.args[i]), call.args[i].pos, [] (index_t l) { return true; }).c_str());
   
   processArgv[call.args.size()] = (char*)nullptr;
 
-  auto result = Node(NodeKind::Num, (NodeValue) { .num = float64(execv(processPath, processArgv)) }, pos);
+  auto result = Value::integer(int32_t(execv(processPath, processArgv)));
 
   // freeing all args including processPath, which is the first arg
-  for (uint64_t i = 0; i < call.args.size(); i++)
+  for (index_t i = 0; i < call.args.size(); i++)
     delete [] processArgv[i];
 
-  return ;
+  return result;
 }
 
-NScript::Node NScript::Evaluator::evaluateCall(CallNode call, Position pos)
+NScript::NodeHandler NScript::Evaluator::resolveBuiltin(cstring_t name, KindSet& kinds)
 {
-  // when the call's name is a string, searches for a process with that filename
-  if (call.name.kind == NodeKind::String)
-    return evaluateCallProcess(call, pos);
-  
-  // otherwise searches for a builtin function with that name
-  auto name = std::string(call.name.value.str);
-
-  if (name == "print")
-    builtinPrint(call);
-  else if (name == "floor")
-    return builtinFloor(call);
-  else if (name == "cd")
-    builtinCd(call);
-  else if (name == "clear")
-    builtinClear(call);
-  else if (name == "shutdown")
-    builtinShutdown(call);
-  else if (name == "ls")
-    builtinLs(call);
-  else if (name == "rmdir")
-    builtinRmDir(call);
-  else if (name == "mkdir")
-    builtinMkDir(call);
-  else if (name == "rmfile")
-    builtinRmFile(call);
-  else if (name == "write")
-    builtinWrite(call);
-  else if (name == "read")
-    return builtinRead(call, pos);
-  else
-    throw Error({"unknown builtin function"}, call.name.pos);
-  
-  return Node::none(pos);
+  struct Builtin
+  {
+    cstring_t   name;
+    NodeHandler handler;
+    KindSet     kinds;  // of the result
+  };
+
+  static const KindSet none    = kindSetOf(NodeKind::None);
+  static const KindSet num     = kindSetOf(NodeKind::Num);
+  static const KindSet integer = kindSetOf(NodeKind::Int);
+  static const KindSet str     = kindSetOf(NodeKind::String);
+  static const KindSet list    = kindSetOf(NodeKind::List);
+
+  static const Builtin builtins[] =
+  {
+    { "print",      callBuiltin<&Evaluator::builtinPrint>,          none },
+    { "floor",      [] (Evaluator& evaluator, Node node) { return evaluator.builtinFloor(*node.value.call); }, integerKinds },
+    { "sqrt",       callBuiltinValue<&Evaluator::builtinSqrt>,      num },
+    { "sin",        callBuiltinValue<&Evaluator::builtinSin>,       num },
+    { "cos",        callBuiltinValue<&Evaluator::builtinCos>,       num },
+    { "atan2",      callBuiltinValue<&Evaluator::builtinAtan2>,     num },
+    { "pow",        callBuiltinValue<&Evaluator::builtinPow>,       numericKinds },
+    { "mathbench",  callBuiltin<&Evaluator::builtinMathBench>,      none },
+    { "cd",         callBuiltin<&Evaluator::builtinCd>,             none },
+    { "clear",      callBuiltin<&Evaluator::builtinClear>,          none },
+    { "shutdown",   callBuiltin<&Evaluator::builtinShutdown>,       none },
+    { "ls",         callBuiltin<&Evaluator::builtinLs>,             none },
+    { "rmdir",      callBuiltin<&Evaluator::builtinRmDir>,          none },
+    { "mkdir",      callBuiltin<&Evaluator::builtinMkDir>,          none },
+    { "rmfile",     callBuiltin<&Evaluator::builtinRmFile>,         none },
+    { "write",      callBuiltin<&Evaluator::builtinWrite>,          none },
+    { "read",       callBuiltinValue<&Evaluator::builtinRead>,      str },
+    { "len",        callBuiltinValue<&Evaluator::builtinLen>,       integer },
+    { "push",       callBuiltin<&Evaluator::builtinPush>,           none },
+    { "lines",      callBuiltinValue<&Evaluator::builtinLines>,     list },
+    { "join",       callBuiltinValue<&Evaluator::builtinJoin>,      str },
+    { "get",        callBuiltinValue<&Evaluator::builtinGet>,       anyKind },
+    { "set",        callBuiltin<&Evaluator::builtinSet>,            none },
+    { "has",        callBuiltinValue<&Evaluator::builtinHas>,       integer },
+    { "del",        callBuiltin<&Evaluator::builtinDel>,            none },
+    { "keys",       callBuiltinValue<&Evaluator::builtinKeys>,      list },
+    { "values",     callBuiltinValue<&Evaluator::builtinValues>,    list },
+    { "match",      callBuiltinValue<&Evaluator::builtinMatch>,     integer },
+    { "find",       callBuiltinValue<&Evaluator::builtinFind>,      str | none },
+    { "replace",    callBuiltinValue<&Evaluator::builtinReplace>,   str },
+    { "grep",       callBuiltinValue<&Evaluator::builtinGrep>,      integer },
+    { "findfiles",  callBuiltinValue<&Evaluator::builtinFindFiles>, integer },
+    { "du",         callBuiltinValue<&Evaluator::builtinDu>,        integerKinds | none },
+    { "cp",         callBuiltin<&Evaluator::builtinCp>,             none },
+    { "mv",         callBuiltin<&Evaluator::builtinMv>,             none },
+    { "crc32",      [] (Evaluator& evaluator, Node node) { auto hasher = Crc32();   return evaluator.builtinHash(*node.value.call, hasher, false); }, str },
+    { "adler32",    [] (Evaluator& evaluator, Node node) { auto hasher = Adler32(); return evaluator.builtinHash(*node.value.call, hasher, false); }, str },
+    { "sha1",       [] (Evaluator& evaluator, Node node) { auto hasher = Sha1();    return evaluator.builtinHash(*node.value.call, hasher, false); }, str },
+    { "md5",        [] (Evaluator& evaluator, Node node) { auto hasher = Md5();     return evaluator.builtinHash(*node.value.call, hasher, false); }, str },
+    { "crc32str",   [] (Evaluator& evaluator, Node node) { auto hasher = Crc32();   return evaluator.builtinHash(*node.value.call, hasher, true); }, str },
+    { "adler32str", [] (Evaluator& evaluator, Node node) { auto hasher = Adler32(); return evaluator.builtinHash(*node.value.call, hasher, true); }, str },
+    { "sha1str",    [] (Evaluator& evaluator, Node node) { auto hasher = Sha1();    return evaluator.builtinHash(*node.value.call, hasher, true); }, str },
+    { "md5str",     [] (Evaluator& evaluator, Node node) { auto hasher = Md5();     return evaluator.builtinHash(*node.value.call, hasher, true); }, str },
+    { "compress",   callBuiltin<&Evaluator::builtinCompress>,       none },
+    { "decompress", callBuiltin<&Evaluator::builtinDecompress>,     none },
+    { "hexdump",    callBuiltin<&Evaluator::builtinHexdump>,        none },
+    { "peek",       callBuiltinValue<&Evaluator::builtinPeek>,      numericKinds },
+  };
+
+  for (const auto& builtin : builtins)
+    if (strcmp(builtin.name, name) == 0)
+    {
+      kinds = builtin.kinds;
+      return builtin.handler;
+    }
+
+  // the error comes when the call runs, after the arguments before it had their effects
+  kinds = anyKind;
+  return [] (Evaluator& evaluator, Node node) -> Value { throw Error({"unknown builtin function"}, node.value.call->name.pos); };
+}
+
+NScript::Value NScript::Evaluator::evaluateListLiteral(ListNode list)
+{
+  auto result = new ListValue();
+
+  result->reserve(list.elements.size());
+
+  for (const auto& element : list.elements)
+    result->push(evaluateNode(element));
+
+  return Value::list(result);
+}
+
+NScript::Value NScript::Evaluator::evaluateDictLiteral(DictNode dict)
+{
+  auto result = new DictValue();
+
+  for (index_t i = 0; i < dict.keys.size(); i++)
+  {
+    auto key = expectType(evaluateNode(dict.keys[i]), NodeKind::String, dict.keys[i].pos);
+    result->set(key.asStr(), evaluateNode(dict.values[i]));
+  }
+
+  return Value::dict(result);
+}
+
+uint32_t NScript::Evaluator::evaluateIndexBound(Node bound, uint32_t length, uint32_t defaultIndex, bool isSliceBound)
+{
+  // omitted slice bound
+  if (bound.kind == NodeKind::None)
+    return defaultIndex;
+
+  auto value = expectType(evaluateNode(bound), NodeKind::Int, bound.pos);
+  auto index = int64_t(value.asInt());
+
+  // negative indices count from the end
+  if (index < 0)
+    index += length;
+
+  // slice bounds may also point right after the last element
+  if (index < 0 || index > int64_t(length) || (!isSliceBound && index == int64_t(length)))
+    throw Error({"index `", std::to_string(value.asInt()), "` out of range (length is `", std::to_string(length), "`)"}, bound.pos);
+
+  return uint32_t(index);
+}
+
+NScript::Value NScript::Evaluator::evaluateIndex(IndexNode index)
+{
+  auto expr = evaluateNode(index.expr);
+
+  // dicts are indexed by key, like `get` without a default value
+  if (expr.kind() == NodeKind::Dict && !index.isSlice)
+  {
+    auto key   = expectType(evaluateNode(index.start), NodeKind::String, index.start.pos);
+    auto value = expr.asDict()->get(key.asStr());
+
+    if (!value)
+      throw Error({"unknown key `", Parser::escapedToEscapes(key.asStr()), "`"}, index.start.pos);
+
+    return *value;
+  }
+
+  if (expr.kind() != NodeKind::List && expr.kind() != NodeKind::String)
+    throw Error({"type `", Node::kindToString(expr.kind()), "` does not support indexing"}, index.expr.pos);
+
+  auto isList = expr.kind() == NodeKind::List;
+  auto length = isList ? expr.asList()->length : uint32_t(strlen(expr.asStr()));
+
+  if (!index.isSlice)
+  {
+    auto i = evaluateIndexBound(index.start, length, 0, false);
+
+    if (!isList)
+      return Value::string(cstringRealloc(std::string(1, expr.asStr()[i]).c_str()));
+
+    return expr.asList()->items[i];
+  }
+
+  auto start = evaluateIndexBound(index.start, length, 0, true);
+  auto end   = std::max(start, evaluateIndexBound(index.end, length, length, true));
+
+  if (!isList)
+    return Value::string(cstringRealloc(std::string(expr.asStr() + start, end - start).c_str()));
+
+  return Value::list(expr.asList()->slice(start, end));
 }
 
-NScript::Node NScript::Evaluator::evaluateAssign(AssignNode assign, Position pos)
+NScript::Value NScript::Evaluator::evaluateAssign(AssignNode& assign)
 {
-  auto name = std::string(assign.name.value.str);
   auto expr = evaluateNode(assign.expr);
 
-  for (uint64_t i = 0; i < map.size(); i++)
-    if (map[i].key == name)
+  // the variable is not declared yet (appends a new definition), the slot then holds since variables are never removed
+  if (assign.slot == NSCRIPT_UNRESOLVED_SLOT)
+  {
+    assign.slot = findVariable(assign.name.value.str);
+
+    if (assign.slot == NSCRIPT_UNRESOLVED_SLOT)
     {
-      // the variable is already declared (overwrites old value)
-      map[i].val = expr;
-      return Node::none(pos);
+      assign.slot = map.size();
+      map.push_back(KeyPair<std::string, Value>(assign.name.value.str, expr));
     }
+  }
 
-  // the variable is not declared yet (appends a new definition)
-  map.push_back(KeyPair<std::string, Node>(name, expr));
-  return Node::none(pos);
+  // otherwise overwrites old value
+  map[assign.slot].val = expr;
+  return Value::none();
 }
 
-NScript::Node NScript::Evaluator::evaluateUna(UnaNode una)
+NScript::Value NScript::Evaluator::evaluateUna(UnaNode una)
 {
   auto term = evaluateNode(una.term);
 
   // unary can only be applied to numbers
-  if (term.kind != NodeKind::Num)
-    throw Error({"type `", Node::kindToString(term.kind), "` does not support unary `", Node::kindToString(una.op.kind), "`"}, term.pos);
+  if (!Node::isNumericKind(term.kind()))
+    throw Error({"type `", Node::kindToString(term.kind()), "` does not support unary `", Node::kindToString(una.op.kind), "`"}, una.term.pos);
   
-  term.value.num *= una.op.kind == NodeKind::Minus ? -1 : +1;
-  return term;
+  if (una.op.kind == NodeKind::Plus)
+    return term;
+
+  switch (term.kind())
+  {
+    case NodeKind::Num:
+      return Value::num(-term.asNum());
+
+    case NodeKind::Int:
+      // -INT32_MIN does not fit 32 bits
+      if (term.asInt() == INT32_MIN)
+        return Value::integer(BigInt(term.asInt()).negated());
+
+      return Value::integer(-term.asInt());
+
+    default:
+      return Value::integer(term.asBigInt()->negated());
+  }
 }
 
 cstring_t NScript::Evaluator::evaluateOperationStr(Node op, cstring_t l, cstring_t r)
@@ -415,77 +932,542 @@ float64 NScript::Evaluator::evaluateOperationNum(NodeKind op, float64 l, float64
         throw Error({"dividing by 0"}, rPos);
 
       return l / r;
+
+    case NodeKind::Percent:
+      if (r == 0)
+        throw Error({"dividing by 0"}, rPos);
+
+      return fmod(l, r);
     
     default: panic("unreachable"); return 0;
   }
 }
 
-NScript::Node NScript::Evaluator::evaluateBin(BinNode bin)
+NScript::Value NScript::Evaluator::evaluateOperationInt(NodeKind op, int32_t l, int32_t r, Position rPos)
 {
-  auto left  = evaluateNode(bin.left);
-  auto right = evaluateNode(bin.right);
+  int32_t         result;
+  Numeric::DivMod division;
 
-  // every bin op can only be applied to values of same type
-  if (left.kind != right.kind)
-    throw Error(
-      {"unkwnon bin `", bin.op.toString(), "` between different types (`", Node::kindToString(left.kind), "` and `", Node::kindToString(right.kind), "`)"},
-      bin.op.pos
-    );
-  
-  // recognizing the values' types
-  switch (left.kind)
+  switch (op)
   {
-    case NodeKind::Num:
-      left.value.num = evaluateOperationNum(bin.op.kind, left.value.num, right.value.num, right.pos);
+    // on overflow the operation is repeated on big integers
+    case NodeKind::Plus:
+      if (__builtin_add_overflow(l, r, &result))
+        return Value::integer(BigInt::add(BigInt(l), BigInt(r)));
+
       break;
-    
-    case NodeKind::String:
-      left.value.str = evaluateOperationStr(bin.op, left.value.str, right.value.str);
+
+    case NodeKind::Minus:
+      if (__builtin_sub_overflow(l, r, &result))
+        return Value::integer(BigInt::sub(BigInt(l), BigInt(r)));
+
       break;
 
-    default:
-      throw Error(
-        {"type `", Node::kindToString(left.kind), "` does not support bin"},
-        bin.op.pos
-      );
+    case NodeKind::Star:
+      if (__builtin_mul_overflow(l, r, &result))
+        return Value::integer(BigInt::mul(BigInt(l), BigInt(r)));
+
+      break;
+
+    // both go through the hardware divider
+    case NodeKind::Slash:
+    case NodeKind::Percent:
+      if (r == 0)
+        throw Error({"dividing by 0"}, rPos);
+
+      // INT32_MIN / -1 does not fit 32 bits (and the remainder of any division by -1 is 0)
+      if (r == -1)
+        return op == NodeKind::Slash ? Value::integer(BigInt(l).negated()) : Value::integer(0);
+
+      division = Numeric::divMod32(l, r);
+
+      if (op == NodeKind::Percent)
+        result = int32_t(division.rem);
+      // the result stays an integer only when the division is exact
+      else if (division.rem != 0)
+        return Value::num(Numeric::divideToFloat(l, r));
+      else
+        result = int32_t(division.quot);
+
+      break;
+
+    default: panic("unreachable"); return Value::none();
   }
 
-  // the returning value is gonna have the same pos of the entire bin node
-  left.pos.endPos = right.pos.endPos;
-  return left;
+  return Value::integer(result);
 }
 
-NScript::Node NScript::Evaluator::evaluateIdentifier(Node identifier)
+NScript::Value NScript::Evaluator::evaluateOperationBigInt(NodeKind op, BigInt l, BigInt r, Position rPos)
 {
-  for (const auto& kv : map)
-    if (kv.key == std::string(identifier.value.str))
-      return kv.val;
-  
-  throw Error({"unknown variable"}, identifier.pos);
-}
+  auto quot = BigInt();
+  auto rem  = BigInt();
 
-NScript::Node NScript::Evaluator::evaluateNode(Node node)
-{
-  switch (node.kind)
+  switch (op)
+  {
+    case NodeKind::Plus:  return Value::integer(BigInt::add(l, r));
+    case NodeKind::Minus: return Value::integer(BigInt::sub(l, r));
+    case NodeKind::Star:  return Value::integer(BigInt::mul(l, r));
+    case NodeKind::Slash:
+      if (r.isZero())
+        throw Error({"dividing by 0"}, rPos);
+
+      BigInt::divMod(l, r, quot, rem);
+
+      // the result stays an integer only when the division is exact
+      if (!rem.isZero())
+        return Value::num(l.toFloat() / r.toFloat());
+
+      return Value::integer(quot);
+
+    case NodeKind::Percent:
+      if (r.isZero())
+        throw Error({"dividing by 0"}, rPos);
+
+      BigInt::divMod(l, r, quot, rem);
+      return Value::integer(rem);
+
+    default: panic("unreachable"); return Value::none();
+  }
+}
+
+NScript::Value NScript::Evaluator::promoteNumeric(Value value, NodeKind kind)
+{
+  if (value.kind() == kind)
+    return value;
+
+  // an integer mixed with a float becomes a float
+  if (kind == NodeKind::Num)
+    return Value::num(value.kind() == NodeKind::Int ? float64(value.asInt()) : value.asBigInt()->toFloat());
+
+  // an immediate integer mixed with a big one becomes big
+  return Value::bigint(new BigInt(value.asInt()));
+}
+
+template<NScript::NodeKind op> NScript::Value NScript::Evaluator::evaluateBinOp(Evaluator& evaluator, Node node)
+{
+  auto bin   = node.value.bin;
+  auto left  = evaluator.evaluateNode(bin->left);
+  auto right = evaluator.evaluateNode(bin->right);
+
+  // the next runs expect the same kinds
+  if (left.kind() == NodeKind::Int && right.kind() == NodeKind::Int)
+    bin->handler = evaluateBinInt<op, false>;
+  else if (left.kind() == NodeKind::Num && right.kind() == NodeKind::Num)
+    bin->handler = evaluateBinNum<op, false>;
+  else if (left.kind() == NodeKind::String && right.kind() == NodeKind::String && op == NodeKind::Plus)
+    bin->handler = evaluateBinStr<false>;
+  else
+    bin->handler = evaluateBinGeneric<op>;
+
+  return evaluator.evaluateBinValues(*bin, left, right);
+}
+
+template<NScript::NodeKind op, bool proven> NScript::Value NScript::Evaluator::evaluateBinInt(Evaluator& evaluator, Node node)
+{
+  auto bin   = node.value.bin;
+  auto left  = evaluator.evaluateNode(bin->left);
+  auto right = evaluator.evaluateNode(bin->right);
+
+  if (!proven && (left.kind() != NodeKind::Int || right.kind() != NodeKind::Int))
+  {
+    bin->handler = evaluateBinGeneric<op>;
+    return evaluator.evaluateBinValues(*bin, left, right);
+  }
+
+  // the operator is a constant here, so the operation runs without any dispatch
+  int32_t result;
+
+  auto overflow =
+    op == NodeKind::Plus  ? __builtin_add_overflow(left.asInt(), right.asInt(), &result) :
+    op == NodeKind::Minus ? __builtin_sub_overflow(left.asInt(), right.asInt(), &result) :
+    op == NodeKind::Star  ? __builtin_mul_overflow(left.asInt(), right.asInt(), &result) : true;
+
+  if (!overflow)
+    return Value::integer(result);
+
+  // overflows and divisions
+  return evaluator.evaluateOperationInt(op, left.asInt(), right.asInt(), bin->right.pos);
+}
+
+template<NScript::NodeKind op, bool proven> NScript::Value NScript::Evaluator::evaluateBinNum(Evaluator& evaluator, Node node)
+{
+  auto bin   = node.value.bin;
+  auto left  = evaluator.evaluateNode(bin->left);
+  auto right = evaluator.evaluateNode(bin->right);
+
+  if (!proven && (left.kind() != NodeKind::Num || right.kind() != NodeKind::Num))
+  {
+    bin->handler = evaluateBinGeneric<op>;
+    return evaluator.evaluateBinValues(*bin, left, right);
+  }
+
+  return Value::num(
+    op == NodeKind::Plus  ? left.asNum() + right.asNum() :
+    op == NodeKind::Minus ? left.asNum() - right.asNum() :
+    op == NodeKind::Star  ? left.asNum() * right.asNum() : evaluator.evaluateOperationNum(op, left.asNum(), right.asNum(), bin->right.pos)
+  );
+}
+
+template<bool proven> NScript::Value NScript::Evaluator::evaluateBinStr(Evaluator& evaluator, Node node)
+{
+  auto bin   = node.value.bin;
+  auto left  = evaluator.evaluateNode(bin->left);
+  auto right = evaluator.evaluateNode(bin->right);
+
+  if (!proven && (left.kind() != NodeKind::String || right.kind() != NodeKind::String))
+  {
+    bin->handler = evaluateBinGeneric<NodeKind::Plus>;
+    return evaluator.evaluateBinValues(*bin, left, right);
+  }
+
+  return Value::string(evaluator.evaluateOperationStr(bin->op, left.asStr(), right.asStr()));
+}
+
+template<NScript::NodeKind op> NScript::Value NScript::Evaluator::evaluateBinGeneric(Evaluator& evaluator, Node node)
+{
+  auto bin   = node.value.bin;
+  auto left  = evaluator.evaluateNode(bin->left);
+  auto right = evaluator.evaluateNode(bin->right);
+
+  return evaluator.evaluateBinValues(*bin, left, right);
+}
+
+NScript::Value NScript::Evaluator::evaluateBinValues(BinNode& bin, Value left, Value right)
+{
+  auto op = bin.op;
+
+  // numbers with different representations are promoted to the widest one
+  if (left.kind() != right.kind() && Node::isNumericKind(left.kind()) && Node::isNumericKind(right.kind()))
+  {
+    auto kind = left.kind() == NodeKind::Num || right.kind() == NodeKind::Num ? NodeKind::Num : NodeKind::BigInt;
+
+    left  = promoteNumeric(left, kind);
+    right = promoteNumeric(right, kind);
+  }
+
+  // every bin op can only be applied to values of same type
+  if (left.kind() != right.kind())
+    throw Error(
+      {"unkwnon bin `", op.toString(), "` between different types (`", Node::kindToString(left.kind()), "` and `", Node::kindToString(right.kind()), "`)"},
+      op.pos
+    );
+  
+  // recognizing the values' types, the errors of the right operand point to its node
+  switch (left.kind())
+  {
+    case NodeKind::Num:    return Value::num(evaluateOperationNum(op.kind, left.asNum(), right.asNum(), bin.right.pos));
+    case NodeKind::Int:    return evaluateOperationInt(op.kind, left.asInt(), right.asInt(), bin.right.pos);
+    case NodeKind::BigInt: return evaluateOperationBigInt(op.kind, *left.asBigInt(), *right.asBigInt(), bin.right.pos);
+    case NodeKind::String: return Value::string(evaluateOperationStr(op, left.asStr(), right.asStr()));
+
+    default:
+      throw Error(
+        {"type `", Node::kindToString(left.kind()), "` does not support bin"},
+        op.pos
+      );
+  }
+}
+
+uint32_t NScript::Evaluator::findVariable(cstring_t name)
+{
+  for (uint32_t i = 0; i < map.size(); i++)
+    if (map[i].key == name)
+      return i;
+
+  return NSCRIPT_UNRESOLVED_SLOT;
+}
+
+NScript::Value NScript::Evaluator::evaluateIdentifier(Node identifier)
+{
+  auto slot = findVariable(identifier.value.str);
+
+  if (slot == NSCRIPT_UNRESOLVED_SLOT)
+    throw Error({"unknown variable"}, identifier.pos);
+
+  return map[slot].val;
+}
+
+NScript::Value NScript::Evaluator::evaluateVariable(Evaluator& evaluator, Node node)
+{
+  auto variable = node.value.variable;
+
+  // a variable assigned after the compilation gets its slot on the first read
+  if (variable->slot == NSCRIPT_UNRESOLVED_SLOT)
+  {
+    variable->slot = evaluator.findVariable(variable->name);
+
+    if (variable->slot == NSCRIPT_UNRESOLVED_SLOT)
+      throw Error({"unknown variable"}, node.pos);
+  }
+
+  variable->handler = loadVariable;
+  return evaluator.map[variable->slot].val;
+}
+
+NScript::Value NScript::Evaluator::loadVariable(Evaluator& evaluator, Node node)
+{
+  return evaluator.map[node.value.variable->slot].val;
+}
+
+// the kind of a set which holds only one
+static inline bool isSingleKind(NScript::KindSet kinds)
+{
+  return kinds != 0 && (kinds & (kinds - 1)) == 0;
+}
+
+static inline NScript::NodeKind singleKind(NScript::KindSet kinds)
+{
+  return NScript::NodeKind(__builtin_ctz(kinds));
+}
+
+template<NScript::NodeKind op> NScript::NodeHandler NScript::Evaluator::bindBin(KindSet left, KindSet right)
+{
+  if (isProvenKind(left, NodeKind::Int) && isProvenKind(right, NodeKind::Int))
+    return evaluateBinInt<op, true>;
+
+  if (isProvenKind(left, NodeKind::Num) && isProvenKind(right, NodeKind::Num))
+    return evaluateBinNum<op, true>;
+
+  if (isProvenKind(left, NodeKind::String) && isProvenKind(right, NodeKind::String) && op == NodeKind::Plus)
+    return evaluateBinStr<true>;
+
+  // the kinds are found out by the first run
+  return evaluateBinOp<op>;
+}
+
+NScript::KindSet NScript::Evaluator::inferBin(BinNode& bin, KindSet left, KindSet right)
+{
+  auto op = bin.op.kind;
+
+  // with both kinds known, the checks of evaluateBinValues are done once here
+  if (isSingleKind(left) && isSingleKind(right))
+  {
+    auto l = singleKind(left);
+    auto r = singleKind(right);
+
+    if (l != r && !(Node::isNumericKind(l) && Node::isNumericKind(r)))
+      throw Error(
+        {"unkwnon bin `", bin.op.toString(), "` between different types (`", Node::kindToString(l), "` and `", Node::kindToString(r), "`)"},
+        bin.op.pos
+      );
+
+    if (l == NodeKind::String && op != NodeKind::Plus)
+      throw Error({"string does not support bin `", Node::kindToString(op), "`"}, bin.op.pos);
+
+    if (l == r && l != NodeKind::String && !Node::isNumericKind(l))
+      throw Error({"type `", Node::kindToString(l), "` does not support bin"}, bin.op.pos);
+  }
+
+  if (((left | right) & ~numericKinds) == 0)
+  {
+    auto kinds = KindSet(0);
+
+    // a float on either side makes the result a float
+    if ((left | right) & kindSetOf(NodeKind::Num))
+      kinds |= kindSetOf(NodeKind::Num);
+
+    // integers on both sides give an integer, a big one on overflow, and a float from a division which is not exact
+    if ((left & integerKinds) && (right & integerKinds))
+      kinds |= integerKinds | (op == NodeKind::Slash ? kindSetOf(NodeKind::Num) : 0);
+
+    return kinds;
+  }
+
+  if (isProvenKind(left, NodeKind::String) && isProvenKind(right, NodeKind::String))
+    return kindSetOf(NodeKind::String);
+
+  // only numbers and strings come out of a bin
+  return numericKinds | kindSetOf(NodeKind::String);
+}
+
+NScript::KindSet NScript::Evaluator::compile(Node& node)
+{
+  switch (node.kind)
+  {
+    case NodeKind::Num:
+    case NodeKind::Int:
+    case NodeKind::BigInt:
+    case NodeKind::String:
+    case NodeKind::List:
+    case NodeKind::Dict:
+    case NodeKind::None:
+      return kindSetOf(node.kind);
+
+    case NodeKind::Identifier:
+      node = Node(NodeKind::Variable, (NodeValue) { .variable = new VariableNode(node.value.str, findVariable(node.value.str)) }, node.pos);
+      return compile(node);
+
+    case NodeKind::Bin:
+    {
+      auto bin   = node.value.bin;
+      auto left  = compile(bin->left);
+      auto right = compile(bin->right);
+
+      bin->kinds = inferBin(*bin, left, right);
+
+      switch (bin->op.kind)
+      {
+        case NodeKind::Plus:    bin->handler = bindBin<NodeKind::Plus>(left, right);    break;
+        case NodeKind::Minus:   bin->handler = bindBin<NodeKind::Minus>(left, right);   break;
+        case NodeKind::Star:    bin->handler = bindBin<NodeKind::Star>(left, right);    break;
+        case NodeKind::Slash:   bin->handler = bindBin<NodeKind::Slash>(left, right);   break;
+        case NodeKind::Percent: bin->handler = bindBin<NodeKind::Percent>(left, right); break;
+        default:                panic("unimplemented bin operator");                     break;
+      }
+
+      return bin->kinds;
+    }
+
+    case NodeKind::Una:
+    {
+      auto una  = node.value.una;
+      auto term = compile(una->term);
+
+      if (isSingleKind(term) && !Node::isNumericKind(singleKind(term)))
+        throw Error({"type `", Node::kindToString(singleKind(term)), "` does not support unary `", Node::kindToString(una->op.kind), "`"}, una->term.pos);
+
+      // negating the smallest integer gives a big one
+      una->kinds   = (term & kindSetOf(NodeKind::Num)) | ((term & integerKinds) ? integerKinds : 0);
+      una->kinds   = una->kinds != 0 ? una->kinds : numericKinds;
+      una->handler = [] (Evaluator& evaluator, Node node) { return evaluator.evaluateUna(*node.value.una); };
+      return una->kinds;
+    }
+
+    // the name of a call and of an assignment stays an identifier, it's not read as a variable
+    case NodeKind::Call:
+    {
+      auto call = node.value.call;
+
+      for (auto& arg : call->args)
+        compile(arg);
+
+      if (call->name.kind == NodeKind::String)
+      {
+        call->kinds   = kindSetOf(NodeKind::Int);
+        call->handler = callBuiltinValue<&Evaluator::evaluateCallProcess>;
+      }
+      else
+        call->handler = resolveBuiltin(call->name.value.str, call->kinds);
+
+      return call->kinds;
+    }
+
+    case NodeKind::Assign:
+      compile(node.value.assign->expr);
+      node.value.assign->slot    = findVariable(node.value.assign->name.value.str);
+      node.value.assign->kinds   = kindSetOf(NodeKind::None);
+      node.value.assign->handler = [] (Evaluator& evaluator, Node node) { return evaluator.evaluateAssign(*node.value.assign); };
+      return node.value.assign->kinds;
+
+    case NodeKind::ListLiteral:
+      for (auto& element : node.value.listLiteral->elements)
+        compile(element);
+
+      node.value.listLiteral->kinds   = kindSetOf(NodeKind::List);
+      node.value.listLiteral->handler = [] (Evaluator& evaluator, Node node) { return evaluator.evaluateListLiteral(*node.value.listLiteral); };
+      return node.value.listLiteral->kinds;
+
+    case NodeKind::DictLiteral:
+    {
+      auto dict = node.value.dictLiteral;
+
+      for (index_t i = 0; i < dict->keys.size(); i++)
+      {
+        auto key = compile(dict->keys[i]);
+
+        if (isSingleKind(key) && singleKind(key) != NodeKind::String)
+          throw Error({"expected a value with type `str` (found `", Node::kindToString(singleKind(key)), "`)"}, dict->keys[i].pos);
+
+        compile(dict->values[i]);
+      }
+
+      dict->kinds   = kindSetOf(NodeKind::Dict);
+      dict->handler = [] (Evaluator& evaluator, Node node) { return evaluator.evaluateDictLiteral(*node.value.dictLiteral); };
+      return dict->kinds;
+    }
+
+    case NodeKind::Index:
+    {
+      auto index = node.value.index;
+      auto expr  = compile(index->expr);
+      auto start = compile(index->start);
+      auto end   = compile(index->end);
+
+      // the checks of evaluateIndex, when the kind of the indexed value is known
+      if (isSingleKind(expr))
+      {
+        auto kind = singleKind(expr);
+
+        if (kind == NodeKind::Dict && !index->isSlice)
+        {
+          if (isSingleKind(start) && singleKind(start) != NodeKind::String)
+            throw Error({"expected a value with type `str` (found `", Node::kindToString(singleKind(start)), "`)"}, index->start.pos);
+        }
+        else if (kind != NodeKind::List && kind != NodeKind::String)
+          throw Error({"type `", Node::kindToString(kind), "` does not support indexing"}, index->expr.pos);
+        else
+        {
+          // omitted slice bounds are `none`
+          auto checkBound = [] (KindSet kinds, Position pos)
+          {
+            if (isSingleKind(kinds) && singleKind(kinds) != NodeKind::Int && singleKind(kinds) != NodeKind::None)
+              throw Error({"expected a value with type `int` (found `", Node::kindToString(singleKind(kinds)), "`)"}, pos);
+          };
+
+          checkBound(start, index->start.pos);
+
+          if (index->isSlice)
+            checkBound(end, index->end.pos);
+        }
+      }
+
+      // slices keep the kind, so do the chars of a string
+      index->kinds   = index->isSlice ? expr & (kindSetOf(NodeKind::List) | kindSetOf(NodeKind::String)) : isProvenKind(expr, NodeKind::String) ? expr : anyKind;
+      index->kinds   = index->kinds != 0 ? index->kinds : anyKind;
+      index->handler = [] (Evaluator& evaluator, Node node) { return evaluator.evaluateIndex(*node.value.index); };
+      return index->kinds;
+    }
+
+    case NodeKind::Variable:
+      node.value.variable->handler = node.value.variable->slot == NSCRIPT_UNRESOLVED_SLOT ? evaluateVariable : loadVariable;
+      return node.value.variable->kinds;
+
+    default:
+      return anyKind;
+  }
+}
+
+NScript::Value NScript::Evaluator::evaluateNode(Node node)
+{
+  // compiled nodes go straight to their handler, a tree which was not compiled is on its first run
+  if (Node::isCompiledKind(node.kind))
+  {
+    if (node.value.compiled->handler == nullptr)
+      compile(node);
+
+    return node.value.compiled->handler(*this, node);
+  }
+
+  switch (node.kind)
   {
     case NodeKind::Num:
+    case NodeKind::Int:
+    case NodeKind::BigInt:
     case NodeKind::String:
-    case NodeKind::None:       return node;
-    case NodeKind::Bin:        return evaluateBin(*node.value.bin);
-    case NodeKind::Una:        return evaluateUna(*node.value.una);
-    case NodeKind::Identifier: return evaluateIdentifier(node);
-    case NodeKind::Assign:     return evaluateAssign(*node.value.assign, node.pos);
-    case NodeKind::Call:       return evaluateCall(*node.value.call, node.pos);
-    default:                   panic("unimplemented evaluateNode for some NodeKind"); return Node::none(node.pos);
+    case NodeKind::List:
+    case NodeKind::Dict:
+    case NodeKind::None:        return Value::fromNode(node);
+    case NodeKind::Identifier:  return evaluateIdentifier(node);
+    default:                    panic("unimplemented evaluateNode for some NodeKind"); return Value::none();
   }
 }
 
-std::string NScript::Evaluator::expectStringLengthAndGetString(Node node, std::function<bool(uint64_t)> f)
+std::string NScript::Evaluator::expectStringLengthAndGetString(Value value, Position pos, std::function<bool(index_t)> f)
 {
-  auto s = std::string(node.value.str);
+  auto s = std::string(expectType(value, NodeKind::String, pos).asStr());
 
   if (!f(s.length()))
-    throw Error({"expected a string with a different length"}, node.pos);
+    throw Error({"expected a string with a different length"}, pos);
   
   return s;
 }
@@ -496,7 +1478,7 @@ void NScript::Evaluator::builtinCd(CallNode call)
 
   // expecting the only 1 arg is a string and expecting it to be a non-empty one
   auto arg            = call.args[0];
-  auto dir            = expectNonEmptyStringAndGetString(expectType(evaluateNode(arg), NodeKind::String));
+  auto dir            = expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos);
   
   dir = getFullPath(dir, false);
 
@@ -520,7 +1502,12 @@ void NScript::Evaluator::builtinCd(CallNode call)
 void NScript::Evaluator::builtinClear(CallNode call)
 {
   expectArgsCount(call, 0);
-  consoleClear();
+
+  // the libnds clear would come through as a screen full of spaces
+  if (TextScreen::active != nullptr)
+    TextScreen::active->clear();
+  else
+    consoleClear();
 }
 
 void NScript::Evaluator::builtinShutdown(CallNode call)
@@ -552,7 +1539,7 @@ void NScript::Evaluator::builtinRmDir(CallNode call)
   expectArgsCount(call, 1);
 
   auto arg  = call.args[0];
-  auto path = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg)), false);
+  auto path = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), false);
 
   // removing all files and sub folders into directory (rmdir can only remove empty folders)
   removeAllInsideDir(path);
@@ -567,7 +1554,7 @@ void NScript::Evaluator::builtinMkDir(CallNode call)
   expectArgsCount(call, 1);
 
   auto arg  = call.args[0];
-  auto path = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg)), false);
+  auto path = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), false);
 
   if (mkdir(path.c_str(), S_IRUSR))
     throw Error({"unable to make folder `", path, "`"}, arg.pos);
@@ -578,7 +1565,7 @@ void NScript::Evaluator::builtinRmFile(CallNode call)
   expectArgsCount(call, 1);
 
   auto arg  = call.args[0];
-  auto path = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg)), true);
+  auto path = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), true);
 
   if (remove(path.c_str()))
     throw Error({"unable to delete file `", path, "`"}, arg.pos);
@@ -590,23 +1577,29 @@ void NScript::Evaluator::builtinWrite(CallNode call)
 
   auto arg     = call.args[0];
   auto arg2    = call.args[1];
-  auto path    = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg)), true);
-  auto content = expectStringLengthAndGetString(evaluateNode(arg2), [] (uint64_t l) { return true; });
+  auto path    = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), true);
+  auto content = expectStringLengthAndGetString(evaluateNode(arg2), arg2.pos, [] (index_t l) { return true; });
   auto file    = fopen(path.c_str(), "wb");
 
   if (!file)
     throw Error({"unable to make file `", path, "`"}, arg.pos);
   
-  fiprintf(file, content.c_str());
+  // written as it is, not as a format string
+  auto sink = FileSink(file);
+
+  sink.write(content);
   fclose(file);
+
+  if (sink.failed)
+    throw Error({"unable to write file `", path, "`"}, arg.pos);
 }
 
-NScript::Node NScript::Evaluator::builtinRead(CallNode call, Position pos)
+NScript::Value NScript::Evaluator::builtinRead(CallNode call)
 {
   expectArgsCount(call, 1);
 
   auto arg     = call.args[0];
-  auto path    = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg)), true);
+  auto path    = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), true);
   auto content = std::string();
   auto file    = fopen(path.c_str(), "rb");
 
@@ -621,12 +1614,751 @@ NScript::Node NScript::Evaluator::builtinRead(CallNode call, Position pos)
   }
 
   fclose(file);
-  return Node(NodeKind::String, (NodeValue) { .str = cstringRealloc(content.c_str()) }, pos);
+  return Value::string(cstringRealloc(content.c_str()));
+}
+
+NScript::Value NScript::Evaluator::builtinLen(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  auto arg = evaluateNode(call.args[0]);
+
+  if (arg.kind() == NodeKind::List)
+    return Value::integer(int32_t(arg.asList()->length));
+
+  if (arg.kind() == NodeKind::Dict)
+    return Value::integer(int32_t(arg.asDict()->length));
+
+  return Value::integer(int32_t(strlen(expectType(arg, NodeKind::String, call.args[0].pos).asStr())));
+}
+
+void NScript::Evaluator::builtinPush(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto list = expectType(evaluateNode(call.args[0]), NodeKind::List, call.args[0].pos).asList();
+
+  list->push(evaluateNode(call.args[1]));
+}
+
+NScript::Value NScript::Evaluator::builtinLines(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  auto text   = expectType(evaluateNode(call.args[0]), NodeKind::String, call.args[0].pos).asStr();
+  auto result = new ListValue();
+
+  // splitting on `\n` without a trailing empty line, like most line oriented tools
+  while (*text != '\0')
+  {
+    auto lineEnd = strchr(text, '\n');
+    auto length  = lineEnd ? size_t(lineEnd - text) : strlen(text);
+
+    result->push(Value::string(cstringRealloc(std::string(text, length).c_str())));
+    text += lineEnd ? length + 1 : length;
+  }
+
+  return Value::list(result);
+}
+
+NScript::Value NScript::Evaluator::builtinJoin(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto list      = expectType(evaluateNode(call.args[0]), NodeKind::List, call.args[0].pos).asList();
+  auto separator = std::string(expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos).asStr());
+  auto result    = std::string();
+
+  for (uint32_t i = 0; i < list->length; i++)
+  {
+    // when this is not the first element
+    if (i > 0)
+      result.append(separator);
+
+    // strings are joined without quotes
+    auto element = list->items[i];
+    result.append(element.kind() == NodeKind::String ? std::string(element.asStr()) : element.toString());
+  }
+
+  return Value::string(cstringRealloc(result.c_str()));
+}
+
+NScript::Value NScript::Evaluator::builtinGet(CallNode call)
+{
+  // the third arg is the default value, returned when the key is missing
+  if (call.args.size() != 3)
+    expectArgsCount(call, 2);
+
+  auto dict  = expectType(evaluateNode(call.args[0]), NodeKind::Dict, call.args[0].pos).asDict();
+  auto key   = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos);
+  auto value = dict->get(key.asStr());
+
+  if (value)
+    return *value;
+
+  if (call.args.size() == 3)
+    return evaluateNode(call.args[2]);
+
+  throw Error({"unknown key `", Parser::escapedToEscapes(key.asStr()), "`"}, call.args[1].pos);
+}
+
+void NScript::Evaluator::builtinSet(CallNode call)
+{
+  expectArgsCount(call, 3);
+
+  auto dict = expectType(evaluateNode(call.args[0]), NodeKind::Dict, call.args[0].pos).asDict();
+  auto key  = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos);
+
+  dict->set(key.asStr(), evaluateNode(call.args[2]));
+}
+
+NScript::Value NScript::Evaluator::builtinHas(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto dict = expectType(evaluateNode(call.args[0]), NodeKind::Dict, call.args[0].pos).asDict();
+  auto key  = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos);
+
+  return Value::integer(int32_t(dict->get(key.asStr()) != nullptr));
+}
+
+void NScript::Evaluator::builtinDel(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto dict = expectType(evaluateNode(call.args[0]), NodeKind::Dict, call.args[0].pos).asDict();
+  auto key  = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos);
+
+  if (!dict->remove(key.asStr()))
+    throw Error({"unknown key `", Parser::escapedToEscapes(key.asStr()), "`"}, call.args[1].pos);
+}
+
+NScript::Value NScript::Evaluator::builtinKeys(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  auto dict   = expectType(evaluateNode(call.args[0]), NodeKind::Dict, call.args[0].pos).asDict();
+  auto result = new ListValue();
+
+  result->reserve(dict->length);
+
+  // the keys are interned and never freed, so the list can point to them directly
+  for (const auto& entry : dict->entries)
+    if (entry.key != nullptr)
+      result->push(Value::string(entry.key));
+
+  return Value::list(result);
+}
+
+NScript::Value NScript::Evaluator::builtinValues(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  auto dict   = expectType(evaluateNode(call.args[0]), NodeKind::Dict, call.args[0].pos).asDict();
+  auto result = new ListValue();
+
+  result->reserve(dict->length);
+
+  for (const auto& entry : dict->entries)
+    if (entry.key != nullptr)
+      result->push(entry.value);
+
+  return Value::list(result);
+}
+
+NScript::Value NScript::Evaluator::builtinMatch(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto regex = expectRegex(evaluateNode(call.args[0]), call.args[0].pos);
+  auto text  = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos).asStr();
+
+  return Value::integer(int32_t(regex->search(text, strlen(text))));
+}
+
+NScript::Value NScript::Evaluator::builtinFind(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto regex = expectRegex(evaluateNode(call.args[0]), call.args[0].pos);
+  auto text  = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos).asStr();
+
+  uint32_t start, end;
+
+  // the leftmost-longest matched text, none when nothing matches
+  if (!regex->find(text, strlen(text), start, end))
+    return Value::none();
+
+  return Value::string(cstringRealloc(std::string(text + start, end - start).c_str()));
+}
+
+NScript::Value NScript::Evaluator::builtinReplace(CallNode call)
+{
+  expectArgsCount(call, 3);
+
+  auto regex       = expectRegex(evaluateNode(call.args[0]), call.args[0].pos);
+  auto text        = expectType(evaluateNode(call.args[1]), NodeKind::String, call.args[1].pos).asStr();
+  auto replacement = expectType(evaluateNode(call.args[2]), NodeKind::String, call.args[2].pos).asStr();
+
+  return Value::string(cstringRealloc(regex->replace(text, strlen(text), replacement).c_str()));
+}
+
+Regex* NScript::Evaluator::expectRegex(Value value, Position pos)
+{
+  auto pattern = std::string(expectType(value, NodeKind::String, pos).asStr());
+
+  for (const auto& kv : regexCache)
+    if (kv.key == pattern)
+      return kv.val;
+
+  auto error = std::string();
+  auto regex = Regex::compile(pattern, error);
+
+  if (regex == nullptr)
+    throw Error({"bad pattern: ", error}, pos);
+
+  // evicting the oldest pattern
+  if (regexCache.size() >= NSCRIPT_REGEX_CACHE_SIZE)
+  {
+    delete regexCache.front().val;
+    regexCache.erase(regexCache.begin());
+  }
+
+  regexCache.push_back(KeyPair<std::string, Regex*>(pattern, regex));
+  return regex;
+}
+
+NScript::Value NScript::Evaluator::builtinGrep(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto patternArg = evaluateNode(call.args[0]);
+  auto pattern    = std::string(expectType(patternArg, NodeKind::String, call.args[0].pos).asStr());
+  auto arg        = call.args[1];
+  auto path       = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), true);
+  auto grep       = Grep(pattern, Grep::isLiteralPattern(pattern) ? nullptr : expectRegex(patternArg, call.args[0].pos));
+  auto matches    = uint32_t(0);
+
+  struct stat info;
+
+  if (stat(path.c_str(), &info))
+    throw Error({"unable to open `", path, "`"}, arg.pos);
+
+  if (!S_ISDIR(info.st_mode))
+  {
+    auto file = fopen(path.c_str(), "rb");
+
+    if (!file)
+      throw Error({"unable to open file `", path, "`"}, arg.pos);
+
+    matches = grepFile(grep, file, path, false);
+    return Value::integer(int32_t(matches));
+  }
+
+  // folders are searched recursively
+  auto walker = DirWalker();
+  expectWalkerOpen(walker, path, arg.pos);
+
+  while (true)
+  {
+    auto event = walker.next();
+
+    if (event == WalkEvent::End)
+      break;
+
+    if (event != WalkEvent::File)
+      continue;
+
+    if (auto file = fopen(walker.path, "rb"))
+      matches += grepFile(grep, file, walker.path, true);
+  }
+
+  return Value::integer(int32_t(matches));
+}
+
+uint32_t NScript::Evaluator::grepFile(Grep& grep, FILE* file, std::string path, bool printPath)
+{
+  auto matches = grep.searchFile(file, [&] (uint32_t lineNumber, const char* line, uint32_t length) {
+    if (printPath)
+      iprintf("%s:", path.c_str());
+
+    iprintf("%u: %.*s\n", unsigned(lineNumber), int(length), line);
+  });
+
+  fclose(file);
+  return matches;
+}
+
+NScript::Value NScript::Evaluator::builtinFindFiles(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  auto arg     = call.args[0];
+  auto path    = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), false);
+  auto regex   = expectRegex(evaluateNode(call.args[1]), call.args[1].pos);
+  auto walker  = DirWalker();
+  auto matches = int32_t(0);
+
+  expectWalkerOpen(walker, path, arg.pos);
+
+  // printing the paths as they are found, matching the pattern against the entry's name only
+  while (true)
+  {
+    auto event = walker.next();
+
+    if (event == WalkEvent::End)
+      break;
+
+    if (event == WalkEvent::LeaveFolder)
+      continue;
+
+    auto name       = walker.path + walker.nameStart;
+    auto nameLength = walker.pathLength - walker.nameStart - (event == WalkEvent::EnterFolder);
+
+    if (regex->search(name, nameLength))
+    {
+      iprintf("%s\n", walker.path);
+      matches++;
+    }
+  }
+
+  return Value::integer(matches);
+}
+
+NScript::Value NScript::Evaluator::builtinDu(CallNode call)
+{
+  expectArgsCount(call, 1);
+
+  auto arg    = call.args[0];
+  auto path   = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), false);
+  auto walker = DirWalker();
+
+  expectWalkerOpen(walker, path, arg.pos);
+
+  // the size of each open folder, the root's one at the bottom
+  auto sizes = std::vector<uint64_t>({ 0 });
+
+  while (true)
+  {
+    auto event = walker.next();
+
+    if (event == WalkEvent::End)
+      break;
+
+    if (event == WalkEvent::EnterFolder)
+      sizes.push_back(0);
+    else if (event == WalkEvent::File)
+    {
+      // dirent has no size, this is the only stat of the traversal
+      struct stat info;
+
+      if (!stat(walker.path, &info))
+        sizes.back() += info.st_size;
+    }
+    else
+    {
+      // each folder is printed as soon as its subtree is complete, like `du`, in kilobytes rounded up
+      auto size = sizes.back();
+      sizes.pop_back();
+
+      iprintf("%lu\t%s\n", (unsigned long)((size + 1023) / 1024), walker.path);
+
+      if (sizes.empty())
+        return Value::integer(::BigInt(int64_t(size)));
+
+      sizes.back() += size;
+    }
+  }
+
+  return Value::none();
+}
+
+void NScript::Evaluator::expectWalkerOpen(DirWalker& walker, std::string path, Position pathPos)
+{
+  path = addTrailingSlashToPath(path);
+
+  if (!walker.open(path))
+    throw Error({"unable to open folder `", path, "`"}, pathPos);
+}
+
+void NScript::Evaluator::builtinCp(CallNode call)
+{
+  std::string src, dst;
+
+  auto isFolder = expectTransferPaths(call, src, dst);
+  copyPath(src, dst, isFolder, call.args[1].pos);
+}
+
+void NScript::Evaluator::builtinMv(CallNode call)
+{
+  std::string src, dst;
+
+  auto isFolder = expectTransferPaths(call, src, dst);
+
+  // on the same volume only the directory entry moves, no data is copied
+  if (Transfer::sameVolume(src, dst) && !rename(src.c_str(), dst.c_str()))
+    return;
+
+  copyPath(src, dst, isFolder, call.args[1].pos);
+
+  if (isFolder)
+  {
+    removeAllInsideDir(src);
+    rmdir(src.c_str());
+  }
+  else
+    remove(src.c_str());
+}
+
+bool NScript::Evaluator::expectTransferPaths(CallNode call, std::string& src, std::string& dst)
+{
+  expectArgsCount(call, 2);
+
+  auto arg  = call.args[0];
+  auto arg2 = call.args[1];
+
+  src = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), true);
+  dst = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg2), arg2.pos), true);
+
+  struct stat info;
+
+  if (stat(src.c_str(), &info))
+    throw Error({"unable to open `", src, "`"}, arg.pos);
+
+  auto isFolder = S_ISDIR(info.st_mode);
+
+  // like `cp` and `mv`, an existing destination folder receives the source with its own name
+  if (!stat(dst.c_str(), &info) && S_ISDIR(info.st_mode))
+  {
+    auto name = src.substr(0, src.find_last_not_of('/') + 1);
+    dst       = addTrailingSlashToPath(dst) + name.substr(name.find_last_of('/') + 1);
+  }
+
+  if (isFolder && addTrailingSlashToPath(dst).rfind(addTrailingSlashToPath(src), 0) == 0)
+    throw Error({"unable to copy `", src, "` into itself"}, arg2.pos);
+
+  // the destination is truncated before the source is read
+  if (!isFolder && Transfer::sameFile(src, dst))
+    throw Error({"unable to copy `", src, "` onto itself"}, arg2.pos);
+
+  return isFolder;
+}
+
+void NScript::Evaluator::copyPath(std::string src, std::string dst, bool isFolder, Position pos)
+{
+  auto stats  = TransferStats();
+  auto timer  = Stopwatch();
+  auto failed = src;
+
+  if (isFolder ? !Transfer::copyFolder(src, dst, stats, failed) : !Transfer::copyFile(src.c_str(), dst.c_str(), stats))
+    throw Error({"unable to copy `", failed, "`"}, pos);
+
+  auto usec = timer.elapsedUsec();
+
+  iprintf(
+    "%lu files, %lu KB in %lu ms (%s)\n",
+    (unsigned long)stats.files, (unsigned long)(stats.bytes / 1024), (unsigned long)(usec / 1000), formatThroughput(stats.bytes, usec).c_str()
+  );
+}
+
+NScript::Value NScript::Evaluator::builtinHash(CallNode call, Hasher& hasher, bool fromString)
+{
+  expectArgsCount(call, 1);
+
+  auto arg   = call.args[0];
+  auto str   = expectType(evaluateNode(arg), NodeKind::String, arg.pos);
+  auto value = str.asStr();
+
+  if (fromString)
+  {
+    hasher.update((const uint8_t*)value, strlen(value));
+    return Value::string(cstringRealloc(hasher.hexDigest().c_str()));
+  }
+
+  auto path = getFullPath(expectNonEmptyStringAndGetString(str, arg.pos), true);
+  auto file = fopen(path.c_str(), "rb");
+
+  if (!file)
+    throw Error({"unable to open file `", path, "`"}, arg.pos);
+
+  // streaming the file through the transfer buffer, without stdio's own buffering
+  setvbuf(file, nullptr, _IONBF, 0);
+
+  auto buffer = (const uint8_t*)Transfer::getBuffer();
+  auto bytes  = uint64_t(0);
+  auto timer  = Stopwatch();
+
+  if (!buffer)
+  {
+    fclose(file);
+    throw Error({"out of memory"}, arg.pos);
+  }
+
+  while (auto read = fread((void*)buffer, 1, TRANSFER_BUFFER_SIZE, file))
+  {
+    hasher.update(buffer, read);
+    bytes += read;
+  }
+
+  fclose(file);
+
+  auto usec = timer.elapsedUsec();
+  iprintf("%lu KB in %lu ms (%s)\n", (unsigned long)(bytes / 1024), (unsigned long)(usec / 1000), formatThroughput(bytes, usec).c_str());
+
+  return Value::string(cstringRealloc(hasher.hexDigest().c_str()));
+}
+
+void NScript::Evaluator::builtinCompress(CallNode call)
+{
+  // the third arg picks the format, 10 (the default, which the bios can decompress) or 11
+  if (call.args.size() != 3)
+    expectArgsCount(call, 2);
+
+  auto format = LzFormat::Lz10;
+
+  if (call.args.size() == 3)
+  {
+    auto arg = expectType(evaluateNode(call.args[2]), NodeKind::Int, call.args[2].pos).asInt();
+
+    if (arg != 10 && arg != 11)
+      throw Error({"expected lz format `10` or `11`"}, call.args[2].pos);
+
+    format = arg == 10 ? LzFormat::Lz10 : LzFormat::Lz11;
+  }
+
+  FILE *in, *out;
+  auto dst = openTransferFiles(call, in, out);
+
+  // the header needs the decompressed size before the data
+  fseek(in, 0, SEEK_END);
+  auto inputSize = uint32_t(ftell(in));
+  fseek(in, 0, SEEK_SET);
+
+  setvbuf(in,  nullptr, _IONBF, 0);
+  setvbuf(out, nullptr, _IONBF, 0);
+
+  auto outputBytes = uint64_t(0);
+  auto error       = std::string();
+  auto timer       = Stopwatch();
+  auto ok          = Lz::compress(in, out, inputSize, format, outputBytes, error);
+  auto usec        = timer.elapsedUsec();
+
+  fclose(in);
+
+  if (fclose(out) && ok)
+  {
+    error = "unable to write the data";
+    ok    = false;
+  }
+
+  // a partial output is not a valid one
+  if (!ok)
+  {
+    remove(dst.c_str());
+    throw Error({"unable to compress: ", error}, call.args[0].pos);
+  }
+
+  iprintf(
+    "%lu KB -> %lu KB (%lu%%) in %lu ms (%s)\n",
+    (unsigned long)(inputSize / 1024), (unsigned long)(outputBytes / 1024), (unsigned long)(inputSize ? outputBytes * 100 / inputSize : 100),
+    (unsigned long)(usec / 1000), formatThroughput(inputSize, usec).c_str()
+  );
+}
+
+void NScript::Evaluator::builtinDecompress(CallNode call)
+{
+  expectArgsCount(call, 2);
+
+  FILE *in, *out;
+  auto dst = openTransferFiles(call, in, out);
+
+  setvbuf(in,  nullptr, _IONBF, 0);
+  setvbuf(out, nullptr, _IONBF, 0);
+
+  auto outputBytes = uint64_t(0);
+  auto error       = std::string();
+  auto timer       = Stopwatch();
+  auto ok          = Lz::decompress(in, out, outputBytes, error);
+  auto usec        = timer.elapsedUsec();
+
+  fclose(in);
+
+  if (fclose(out) && ok)
+  {
+    error = "unable to write the data";
+    ok    = false;
+  }
+
+  if (!ok)
+  {
+    remove(dst.c_str());
+    throw Error({"unable to decompress: ", error}, call.args[0].pos);
+  }
+
+  iprintf("%lu KB in %lu ms (%s)\n", (unsigned long)(outputBytes / 1024), (unsigned long)(usec / 1000), formatThroughput(outputBytes, usec).c_str());
+}
+
+std::string NScript::Evaluator::openTransferFiles(CallNode call, FILE*& in, FILE*& out)
+{
+  auto arg  = call.args[0];
+  auto arg2 = call.args[1];
+  auto src  = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg), arg.pos), true);
+  auto dst  = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(arg2), arg2.pos), true);
+
+  // the destination is truncated before the source is read
+  if (Transfer::sameFile(src, dst))
+    throw Error({"unable to transfer `", src, "` onto itself"}, arg2.pos);
+
+  in = fopen(src.c_str(), "rb");
+
+  if (!in)
+    throw Error({"unable to open file `", src, "`"}, arg.pos);
+
+  out = fopen(dst.c_str(), "wb");
+
+  if (!out)
+  {
+    fclose(in);
+    throw Error({"unable to make file `", dst, "`"}, arg2.pos);
+  }
+
+  return dst;
+}
+
+void NScript::Evaluator::builtinHexdump(CallNode call)
+{
+  expectArgsCount(call, 3);
+
+  auto file   = openFileAt(call.args[0], call.args[1]);
+  auto offset = uint64_t(ftell(file));
+  auto length = expectType(evaluateNode(call.args[2]), NodeKind::Int, call.args[2].pos).asInt();
+
+  if (length < 0)
+  {
+    fclose(file);
+    throw Error({"expected a positive length"}, call.args[2].pos);
+  }
+
+  // only the requested range is read, a chunk at a time, and each chunk's rows are written with a single call
+  uint8_t chunk[HEXDUMP_CHUNK_SIZE];
+  char    rows[HEXDUMP_CHUNK_SIZE / HEXDUMP_BYTES_PER_ROW * HEXDUMP_ROW_CAPACITY];
+
+  auto remaining = uint32_t(length);
+
+  while (remaining > 0)
+  {
+    auto read = fread(chunk, 1, remaining < HEXDUMP_CHUNK_SIZE ? remaining : HEXDUMP_CHUNK_SIZE, file);
+
+    if (read == 0)
+      break;
+
+    auto rowsLength = uint32_t(0);
+
+    for (uint32_t i = 0; i < read; i += HEXDUMP_BYTES_PER_ROW)
+    {
+      auto count  = read - i < HEXDUMP_BYTES_PER_ROW ? read - i : HEXDUMP_BYTES_PER_ROW;
+      rowsLength += HexDump::formatRow(rows + rowsLength, offset + i, chunk + i, count);
+    }
+
+    fwrite(rows, 1, rowsLength, stdout);
+
+    offset    += read;
+    remaining -= read;
+  }
+
+  fclose(file);
+  fflush(stdout);
+}
+
+NScript::Value NScript::Evaluator::builtinPeek(CallNode call)
+{
+  expectArgsCount(call, 3);
+
+  auto typeArg = expectType(evaluateNode(call.args[2]), NodeKind::String, call.args[2].pos);
+  auto type    = std::string(typeArg.asStr());
+
+  // little endian values, like everything the ds writes
+  auto sizes = std::vector<KeyPair<std::string, uint32_t>>({
+    KeyPair<std::string, uint32_t>("u8",  1), KeyPair<std::string, uint32_t>("i8",  1),
+    KeyPair<std::string, uint32_t>("u16", 2), KeyPair<std::string, uint32_t>("i16", 2),
+    KeyPair<std::string, uint32_t>("u32", 4), KeyPair<std::string, uint32_t>("i32", 4),
+    KeyPair<std::string, uint32_t>("u64", 8), KeyPair<std::string, uint32_t>("i64", 8),
+    KeyPair<std::string, uint32_t>("f32", 4), KeyPair<std::string, uint32_t>("f64", 8),
+  });
+
+  auto size = uint32_t(0);
+
+  for (const auto& kv : sizes)
+    if (kv.key == type)
+      size = kv.val;
+
+  if (size == 0)
+    throw Error({"unknown type `", type, "` (expected u8, i8, u16, i16, u32, i32, u64, i64, f32 or f64)"}, call.args[2].pos);
+
+  auto file = openFileAt(call.args[0], call.args[1]);
+
+  uint8_t bytes[8];
+  auto    read = fread(bytes, 1, size, file);
+
+  fclose(file);
+
+  if (read != size)
+    throw Error({"the value is past the end of the file"}, call.args[1].pos);
+
+  auto bits = uint64_t(0);
+
+  for (auto i = int(size) - 1; i >= 0; i--)
+    bits = bits << 8 | bytes[i];
+
+  if (type == "f32" || type == "f64")
+  {
+    float64 value;
+
+    if (size == 4)
+    {
+      float32 single;
+      auto    word = uint32_t(bits);
+
+      memcpy(&single, &word, 4);
+      value = single;
+    }
+    else
+      memcpy(&value, &bits, 8);
+
+    // a nan read from the file (of either width) carries an arbitrary payload, Value::num makes it the canonical one
+    return Value::num(value);
+  }
+
+  // sign extending the signed types
+  if (type[0] == 'i')
+    return Value::integer(::BigInt(int64_t(bits << (64 - size * 8)) >> (64 - size * 8)));
+
+  return bits <= uint64_t(INT64_MAX) ? Value::integer(::BigInt(int64_t(bits))) : Value::integer(::BigInt::fromString(std::to_string(bits)));
+}
+
+FILE* NScript::Evaluator::openFileAt(Node pathArg, Node offsetArg)
+{
+  auto path   = getFullPath(expectNonEmptyStringAndGetString(evaluateNode(pathArg), pathArg.pos), true);
+  auto offset = expectType(evaluateNode(offsetArg), NodeKind::Int, offsetArg.pos).asInt();
+
+  if (offset < 0)
+    throw Error({"expected a positive offset"}, offsetArg.pos);
+
+  auto file = fopen(path.c_str(), "rb");
+
+  if (!file)
+    throw Error({"unable to open file `", path, "`"}, pathArg.pos);
+
+  // the small reads don't need stdio's buffer, which would read ahead a whole block
+  setvbuf(file, nullptr, _IONBF, 0);
+  fseek(file, offset, SEEK_SET);
+
+  return file;
 }
 
-std::string NScript::Evaluator::expectNonEmptyStringAndGetString(Node node)
+std::string NScript::Evaluator::expectNonEmptyStringAndGetString(Value value, Position pos)
 {
-  return expectStringLengthAndGetString(node, [] (uint64_t l) { return l > 0; });
+  return expectStringLengthAndGetString(value, pos, [] (index_t l) { return l > 0; });
 }
 
 std::string NScript::Evaluator::getFullPath(std::string path, bool shouldBeFile)
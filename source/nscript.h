@@ -9,15 +9,33 @@
 #include <dirent.h>
 
 #include "basics.h"
+#include "bignum.h"
+#include "fastmath.h"
+#include "numeric.h"
+#include "regex.h"
+#include "grep.h"
+#include "walk.h"
+#include "transfer.h"
+#include "checksum.h"
+#include "lz.h"
+#include "hexdump.h"
+#include "sink.h"
+#include "screen.h"
+
+// compiled patterns kept by the evaluator, so a pattern applied in a loop is only compiled once
+#define NSCRIPT_REGEX_CACHE_SIZE 16
+
+// the variable slot of a name which was not declared yet
+#define NSCRIPT_UNRESOLVED_SLOT  UINT32_MAX
 
 namespace NScript
 {
   class Position
   {
-    public: uint64_t startPos;
-    public: uint64_t endPos;
+    public: index_t startPos;
+    public: index_t endPos;
 
-    public: Position(uint64_t startPos, uint64_t endPos)
+    public: Position(index_t startPos, index_t endPos)
     {
       this->startPos = startPos;
       this->endPos   = endPos;
@@ -28,48 +46,111 @@ namespace NScript
       *this = Position(0, 0);
     }
 
-    public: inline uint64_t length()
+    public: inline index_t length()
     {
       return endPos - startPos;
     }
   };
 
+  // the kinds up to `Variable` are the ones Evaluator::compile binds to a handler
   enum class NodeKind
   {
     Bin,
     Una,
     Call,
     Assign,
+    ListLiteral,
+    DictLiteral,
+    Index,
+    Variable,
     Bad,
     Eof,
     None,
     Num,
+    Int,
+    BigInt,
     String,
+    List,
+    Dict,
     Identifier,
-    Plus  = '+',
-    Minus = '-',
-    Star  = '*',
-    Slash = '/',
-    LPar  = '(',
-    RPar  = ')',
-    Comma = ',',
-    Eq    = '=',
+    Plus    = '+',
+    Minus   = '-',
+    Star    = '*',
+    Slash   = '/',
+    Percent = '%',
+    LPar    = '(',
+    RPar    = ')',
+    Comma   = ',',
+    Eq      = '=',
+    LBrack  = '[',
+    RBrack  = ']',
+    Colon   = ':',
+    LBrace  = '{',
+    RBrace  = '}',
   };
 
+  // the kinds a node can evaluate to, one bit per value kind, as inferred before running it
+  typedef uint32_t KindSet;
+
+  static const KindSet anyKind = 0xFFFFFFFF;
+
+  static inline KindSet kindSetOf(NodeKind kind)
+  {
+    return KindSet(1) << uint32_t(kind);
+  }
+
+  // the node evaluates to this kind only
+  static inline bool isProvenKind(KindSet kinds, NodeKind kind)
+  {
+    return kinds == kindSetOf(kind);
+  }
+
+  static const KindSet integerKinds = kindSetOf(NodeKind::Int) | kindSetOf(NodeKind::BigInt);
+  static const KindSet numericKinds = kindSetOf(NodeKind::Num) | integerKinds;
+
   class BinNode;
   class UnaNode;
   class CallNode;
   class AssignNode;
+  class ListNode;
+  class DictNode;
+  class IndexNode;
+  class VariableNode;
+  class CompiledNode;
+  class ListValue;
+  class DictValue;
   
   union NodeValue
   {
-    public: float64     num;
-    public: cstring_t   str;
-    public: BinNode*    bin;
-    public: UnaNode*    una;
-    public: CallNode*   call;
-    public: AssignNode* assign;
-    public: void_t      none;
+    public: float64       num;
+    public: int32_t       integer;
+    public: ::BigInt*     bigint;
+    public: cstring_t     str;
+    public: BinNode*      bin;
+    public: UnaNode*      una;
+    public: CallNode*     call;
+    public: AssignNode*   assign;
+    public: ListNode*     listLiteral;
+    public: DictNode*     dictLiteral;
+    public: IndexNode*    index;
+    public: VariableNode* variable;
+    public: CompiledNode* compiled;  // any of the payloads above, which all start with it
+    public: ListValue*    list;
+    public: DictValue*    dict;
+    public: void_t        none;
+  };
+
+  class Evaluator;
+  class Node;
+  class Value;
+
+  // the evaluation of a node, picked once for its operator and payload by Evaluator::compile
+  typedef Value (*NodeHandler)(Evaluator& evaluator, Node node);
+
+  class CompiledNode
+  {
+    public: NodeHandler handler = nullptr;
+    public: KindSet     kinds   = anyKind;
   };
 
   class Node
@@ -110,11 +191,18 @@ namespace NScript
       switch (kind)
       {
         case NodeKind::Num:         return "num";
+        case NodeKind::Int:         return "int";
+        case NodeKind::BigInt:      return "bigint";
         case NodeKind::String:      return "str";
         case NodeKind::Bin:         return "bin";
         case NodeKind::Una:         return "una";
         case NodeKind::Call:        return "call";
         case NodeKind::Assign:      return "assign";
+        case NodeKind::ListLiteral:
+        case NodeKind::List:        return "list";
+        case NodeKind::DictLiteral:
+        case NodeKind::Dict:        return "dict";
+        case NodeKind::Index:       return "index";
         case NodeKind::None:        return "none";
         case NodeKind::Plus:
         case NodeKind::Minus:
@@ -123,7 +211,14 @@ namespace NScript
         case NodeKind::RPar:
         case NodeKind::Comma:
         case NodeKind::Eq:
-        case NodeKind::Slash:       return std::string(1, char(kind));
+        case NodeKind::LBrack:
+        case NodeKind::RBrack:
+        case NodeKind::Colon:
+        case NodeKind::LBrace:
+        case NodeKind::RBrace:
+        case NodeKind::Slash:
+        case NodeKind::Percent:     return std::string(1, char(kind));
+        case NodeKind::Variable:
         case NodeKind::Identifier:  return "id";
         case NodeKind::Bad:         return "<bad>";
         case NodeKind::Eof:         return "<eof>";
@@ -133,10 +228,203 @@ namespace NScript
       return nullptr;
     }
 
+    public: static inline bool isCompiledKind(NodeKind kind)
+    {
+      return kind <= NodeKind::Variable;
+    }
+
+    public: static inline bool isNumericKind(NodeKind kind)
+    {
+      return kind == NodeKind::Num || kind == NodeKind::Int || kind == NodeKind::BigInt;
+    }
+
+    // small integers stay immediate, only the ones overflowing 32 bits are allocated
+    public: static Node integer(::BigInt value, Position pos)
+    {
+      if (value.fitsInt32())
+        return Node(NodeKind::Int, (NodeValue) { .integer = value.toInt32() }, pos);
+
+      return Node(NodeKind::BigInt, (NodeValue) { .bigint = new ::BigInt(value) }, pos);
+    }
+
     public: std::string toString();
+
+    // streams the same text of `toString` into `sink`, without building intermediate strings
+    public: void writeTo(OutputSink& sink);
   };
 
-  class BinNode
+  // a runtime value in one 64 bits word, without the source position a Node carries.
+  // floats are stored as they are (with every nan made the same quiet one), the other kinds live in the nan space
+  // above it: the top 16 bits are the tag and the low 48 the payload (an immediate integer or a pointer)
+  class Value
+  {
+    private: uint64_t bits;
+
+    private: static const uint64_t canonicalNan = 0x7FF8000000000000ull;
+    private: static const uint64_t payloadMask  = 0x0000FFFFFFFFFFFFull;
+    private: static const uint64_t intTag       = 0xFFF9ull << 48;
+    private: static const uint64_t noneTag      = 0xFFFAull << 48;
+    private: static const uint64_t bigintTag    = 0xFFFBull << 48;
+    private: static const uint64_t stringTag    = 0xFFFCull << 48;
+    private: static const uint64_t listTag      = 0xFFFDull << 48;
+    private: static const uint64_t dictTag      = 0xFFFEull << 48;
+
+    public: Value()
+    {
+      this->bits = noneTag;
+    }
+
+    private: static inline Value tagged(uint64_t tag, uint64_t payload)
+    {
+      auto value = Value();
+
+      value.bits = tag | (payload & payloadMask);
+      return value;
+    }
+
+    public: static inline Value num(float64 num)
+    {
+      auto value = Value();
+
+      // testing the bits, `num != num` is folded away by -ffast-math and a nan payload could forge a tag
+      if (isNanFloat(num))
+        value.bits = canonicalNan;
+      else
+        memcpy(&value.bits, &num, sizeof(float64));
+
+      return value;
+    }
+
+    public: static inline Value integer(int32_t integer)
+    {
+      return tagged(intTag, uint32_t(integer));
+    }
+
+    public: static inline Value none()
+    {
+      return Value();
+    }
+
+    public: static inline Value string(cstring_t str)
+    {
+      return tagged(stringTag, uintptr_t(str));
+    }
+
+    public: static inline Value bigint(::BigInt* bigint)
+    {
+      return tagged(bigintTag, uintptr_t(bigint));
+    }
+
+    // like Node::integer, a big integer is allocated only when it doesn't fit the immediate
+    public: static inline Value integer(::BigInt value)
+    {
+      if (value.fitsInt32())
+        return integer(value.toInt32());
+
+      return bigint(new ::BigInt(value));
+    }
+
+    public: static inline Value list(ListValue* list)
+    {
+      return tagged(listTag, uintptr_t(list));
+    }
+
+    public: static inline Value dict(DictValue* dict)
+    {
+      return tagged(dictTag, uintptr_t(dict));
+    }
+
+    public: inline NodeKind kind() const
+    {
+      switch (bits & ~payloadMask)
+      {
+        case intTag:    return NodeKind::Int;
+        case noneTag:   return NodeKind::None;
+        case bigintTag: return NodeKind::BigInt;
+        case stringTag: return NodeKind::String;
+        case listTag:   return NodeKind::List;
+        case dictTag:   return NodeKind::Dict;
+        default:        return NodeKind::Num;
+      }
+    }
+
+    public: inline float64 asNum() const
+    {
+      float64 num;
+
+      memcpy(&num, &bits, sizeof(float64));
+      return num;
+    }
+
+    public: inline int32_t asInt() const
+    {
+      return int32_t(uint32_t(bits));
+    }
+
+    // the payload of the pointer kinds
+    private: inline void* asPointer() const
+    {
+      return (void*)uintptr_t(bits & payloadMask);
+    }
+
+    public: inline ::BigInt* asBigInt() const
+    {
+      return (::BigInt*)asPointer();
+    }
+
+    public: inline cstring_t asStr() const
+    {
+      return (cstring_t)asPointer();
+    }
+
+    public: inline ListValue* asList() const
+    {
+      return (ListValue*)asPointer();
+    }
+
+    public: inline DictValue* asDict() const
+    {
+      return (DictValue*)asPointer();
+    }
+
+    // `node` must hold a value, not syntax
+    public: static inline Value fromNode(const Node& node)
+    {
+      switch (node.kind)
+      {
+        case NodeKind::Num:    return num(node.value.num);
+        case NodeKind::Int:    return integer(node.value.integer);
+        case NodeKind::None:   return none();
+        case NodeKind::BigInt: return bigint(node.value.bigint);
+        case NodeKind::String: return string(node.value.str);
+        case NodeKind::List:   return list(node.value.list);
+        case NodeKind::Dict:   return dict(node.value.dict);
+        default:               panic("Value::fromNode() of a syntax node"); return none();
+      }
+    }
+
+    // the value as a node, where it's used in the source at `pos`
+    public: inline Node toNode(Position pos) const
+    {
+      switch (kind())
+      {
+        case NodeKind::Num:    return Node(NodeKind::Num, (NodeValue) { .num = asNum() }, pos);
+        case NodeKind::Int:    return Node(NodeKind::Int, (NodeValue) { .integer = asInt() }, pos);
+        case NodeKind::BigInt: return Node(NodeKind::BigInt, (NodeValue) { .bigint = asBigInt() }, pos);
+        case NodeKind::String: return Node(NodeKind::String, (NodeValue) { .str = asStr() }, pos);
+        case NodeKind::List:   return Node(NodeKind::List, (NodeValue) { .list = asList() }, pos);
+        case NodeKind::Dict:   return Node(NodeKind::Dict, (NodeValue) { .dict = asDict() }, pos);
+        default:               return Node::none(pos);
+      }
+    }
+
+    public: std::string toString() const;
+
+    // the same text a node holding the value writes
+    public: void writeTo(OutputSink& sink) const;
+  };
+
+  class BinNode : public CompiledNode
   {
     public: Node left;
     public: Node right;
@@ -150,7 +438,7 @@ namespace NScript
     }
   };
 
-  class UnaNode
+  class UnaNode : public CompiledNode
   {
     public: Node term;
     public: Node op;
@@ -162,7 +450,7 @@ namespace NScript
     }
   };
 
-  class CallNode
+  class CallNode : public CompiledNode
   {
     public: Node              name;
     public: std::vector<Node> args;
@@ -174,15 +462,69 @@ namespace NScript
     }
   };
 
-  class AssignNode
+  class AssignNode : public CompiledNode
   {
-    public: Node name;
-    public: Node expr;
+    public: Node     name;
+    public: Node     expr;
+    public: uint32_t slot;  // in the variables of the evaluator which compiled it
 
     public: AssignNode(Node name, Node expr)
     {
       this->name = name;
       this->expr = expr;
+      this->slot = NSCRIPT_UNRESOLVED_SLOT;
+    }
+  };
+
+  class ListNode : public CompiledNode
+  {
+    public: std::vector<Node> elements;
+
+    public: ListNode(std::vector<Node> elements)
+    {
+      this->elements = elements;
+    }
+  };
+
+  class DictNode : public CompiledNode
+  {
+    public: std::vector<Node> keys;
+    public: std::vector<Node> values;
+
+    public: DictNode(std::vector<Node> keys, std::vector<Node> values)
+    {
+      this->keys   = keys;
+      this->values = values;
+    }
+  };
+
+  // `expr[start]` or `expr[start:end]`, omitted slice bounds are `none`
+  class IndexNode : public CompiledNode
+  {
+    public: Node expr;
+    public: Node start;
+    public: Node end;
+    public: bool isSlice;
+
+    public: IndexNode(Node expr, Node start, Node end, bool isSlice)
+    {
+      this->expr    = expr;
+      this->start   = start;
+      this->end     = end;
+      this->isSlice = isSlice;
+    }
+  };
+
+  // an identifier read as a variable, bound to its slot once the variable is declared
+  class VariableNode : public CompiledNode
+  {
+    public: cstring_t name;
+    public: uint32_t  slot;
+
+    public: VariableNode(cstring_t name, uint32_t slot)
+    {
+      this->name = name;
+      this->slot = slot;
     }
   };
 
@@ -201,7 +543,7 @@ namespace NScript
   class Parser
   {
     private: std::string expression;
-    private: uint64_t    exprIndex;
+    private: index_t     exprIndex;
     private: Node        curToken;
     private: Node        prevToken;
 
@@ -213,6 +555,10 @@ namespace NScript
 
     public: inline Node parse()
     {
+      // the positions of the tokens go up to one past the end of the expression
+      if (expression.length() >= INDEX_MAX)
+        throw Error({"expression too long"}, Position());
+
       // fetching the first token
       advance();
 
@@ -228,12 +574,14 @@ namespace NScript
     private: inline Node expectExpression()
     {
       // expression     = sub_expression +|- sub_expression ...
-      // sub_expression = term           *|/ term           ...
-      // term           = id|num|str
+      // sub_expression = term           *|/|% term         ...
+      // term           = id|num|str|list ([index] or [start:end] ...)
+      // list           = [ expression, ... ]
+      // dict           = { expression: expression, ... }
       return expectBinaryOrTerm([this] {
         return expectBinaryOrTerm([this] {
           return expectTerm();
-        }, { NodeKind::Star, NodeKind::Slash });
+        }, { NodeKind::Star, NodeKind::Slash, NodeKind::Percent });
       }, { NodeKind::Plus, NodeKind::Minus });
     }
 
@@ -266,12 +614,12 @@ namespace NScript
       return curToken;
     }
 
-    private: inline char curChar(uint64_t count = 0)
+    private: inline char curChar(index_t count = 0)
     {
       return expression[exprIndex + count];
     }
 
-    private: inline Position curPos(uint64_t count = 0)
+    private: inline Position curPos(index_t count = 0)
     {
       return Position(exprIndex + count, exprIndex + count + 1);
     }
@@ -281,7 +629,7 @@ namespace NScript
       return curToken.kind == NodeKind::Eof;
     }
 
-    private: inline bool eof(uint64_t count = 0)
+    private: inline bool eof(index_t count = 0)
     {
       return exprIndex + count >= expression.length();
     }
@@ -322,9 +670,9 @@ namespace NScript
       return prevToken;
     }
     
-    private: inline uint64_t countOccurrences(std::string s, char toCheck)
+    private: inline index_t countOccurrences(std::string s, char toCheck)
     {
-      uint64_t t = 0;
+      index_t t = 0;
 
       for (const auto& c : s)
         t += !!(c == toCheck);
@@ -346,7 +694,8 @@ namespace NScript
       }
     }
 
-    private: static inline std::string escapedToEscapeOrNothing(char c)
+    // the escape of `c`, or nullptr when the char is written as it is
+    private: static inline cstring_t escapeOf(char c)
     {
       switch (c)
       {
@@ -356,22 +705,47 @@ namespace NScript
         case '\n': return "\\n";
         case '\t': return "\\t";
         case '\0': return "\\0";
-        default:   return std::string(1, c);
+        default:   return nullptr;
+      }
+    }
+
+    // writes the `length` chars of `s` with the special ones as escapes, the runs of plain chars in one piece
+    public: static void writeEscapes(OutputSink& sink, const char* s, uint32_t length)
+    {
+      auto run = s;
+      auto end = s + length;
+
+      for (; s < end; s++)
+      {
+        auto escape = escapeOf(*s);
+
+        if (escape == nullptr)
+          continue;
+
+        sink.write(run, s - run);
+        sink.write(escape);
+        run = s + 1;
       }
+
+      sink.write(run, s - run);
     }
 
     public: inline static std::string escapedToEscapes(std::string s)
     {
-      std::string t;
+      auto sink = StringSink();
 
-      for (const auto& c : s)
-        t.append(escapedToEscapeOrNothing(c));
-      
-      return t;
+      writeEscapes(sink, s.data(), s.length());
+      return sink.result;
     }
 
     private: Node collectCallNode(Node name);
 
+    private: Node collectListNode();
+
+    private: Node collectDictNode();
+
+    private: Node collectIndexNode(Node expr);
+
     private: Node expectTerm();
 
     private: std::string collectSequence(std::function<bool()> checker);
@@ -393,36 +767,110 @@ namespace NScript
 
   class Evaluator
   {
-    public:  std::string                             cwd;       // current working directory
-    public:  std::vector<KeyPair<std::string, Node>> map;       // declared variables map
+    public:  std::string                               cwd;         // current working directory
+    public:  std::vector<KeyPair<std::string, Value>>  map;         // declared variables map, their values without positions
+    private: std::vector<KeyPair<std::string, Regex*>> regexCache;  // oldest first
 
     public: Evaluator()
     {
-      this->map = std::vector<KeyPair<std::string, Node>>();
+      this->map = std::vector<KeyPair<std::string, Value>>();
       this->cwd = "/";
     }
 
-    public: Node evaluateNode(Node node);
+    // values carry no position, the errors about them point to the nodes they were evaluated from
+    public: Value evaluateNode(Node node);
+
+    // binds every compound node of the tree to its handler, and its identifiers to variable slots,
+    // so running the tree does no more decoding of kinds, operators and names.
+    // it also infers the kinds each node can evaluate to, returned for `node`, and throws the type errors
+    // which are certain before anything runs; the bins with proven operand kinds skip the runtime checks
+    public: KindSet compile(Node& node);
+
+    private: Value evaluateIdentifier(Node identifier);
+
+    private: uint32_t findVariable(cstring_t name);
+
+    // the first read of a variable, which then quickens into `loadVariable`
+    private: static Value evaluateVariable(Evaluator& evaluator, Node node);
+
+    private: static Value loadVariable(Evaluator& evaluator, Node node);
+
+    // the first run of a bin, which quickens it into the handler specialized for the operand kinds it saw
+    private: template<NodeKind op> static Value evaluateBinOp(Evaluator& evaluator, Node node);
 
-    private: Node evaluateIdentifier(Node identifier);
+    // the specialized handlers guard their operand kinds, and on a miss the bin falls back to `evaluateBinGeneric` for good,
+    // unless the kinds were `proven` by the compilation
+    private: template<NodeKind op, bool proven> static Value evaluateBinInt(Evaluator& evaluator, Node node);
 
-    private: Node evaluateBin(BinNode bin);
+    private: template<NodeKind op, bool proven> static Value evaluateBinNum(Evaluator& evaluator, Node node);
+
+    private: template<bool proven> static Value evaluateBinStr(Evaluator& evaluator, Node node);
+
+    private: template<NodeKind op> static Value evaluateBinGeneric(Evaluator& evaluator, Node node);
+
+    private: Value evaluateBinValues(BinNode& bin, Value left, Value right);
 
     private: float64 evaluateOperationNum(NodeKind op, float64 l, float64 r, Position rPos);
 
+    private: Value evaluateOperationInt(NodeKind op, int32_t l, int32_t r, Position rPos);
+
+    private: Value evaluateOperationBigInt(NodeKind op, ::BigInt l, ::BigInt r, Position rPos);
+
+    private: Value promoteNumeric(Value value, NodeKind kind);
+
     private: cstring_t evaluateOperationStr(Node op, cstring_t l, cstring_t r);
 
-    private: Node evaluateUna(UnaNode una);
+    private: Value evaluateUna(UnaNode una);
 
-    private: Node evaluateAssign(AssignNode assign, Position pos);
+    private: Value evaluateAssign(AssignNode& assign);
 
-    private: Node evaluateCall(CallNode call, Position pos);
+    // the handler of a bin, chosen from the operand kinds inferred for it
+    private: template<NodeKind op> static NodeHandler bindBin(KindSet left, KindSet right);
 
-    private: Node evaluateCallProcess(CallNode call, Position pos);
+    // the kinds a bin evaluates to, throwing when its operand kinds can't go together
+    private: static KindSet inferBin(BinNode& bin, KindSet left, KindSet right);
+
+    private: static NodeHandler resolveBuiltin(cstring_t name, KindSet& kinds);
+
+    private: Value evaluateCallProcess(CallNode call);
+
+    private: Value evaluateListLiteral(ListNode list);
+
+    private: Value evaluateDictLiteral(DictNode dict);
+
+    private: Value evaluateIndex(IndexNode index);
+
+    private: uint32_t evaluateIndexBound(Node bound, uint32_t length, uint32_t defaultIndex, bool isSliceBound);
+
+    // the builtins as handlers of their call nodes
+    private: template<void (Evaluator::*builtin)(CallNode)> static Value callBuiltin(Evaluator& evaluator, Node node)
+    {
+      (evaluator.*builtin)(*node.value.call);
+      return Value::none();
+    }
+
+    private: template<Value (Evaluator::*builtin)(CallNode)> static Value callBuiltinValue(Evaluator& evaluator, Node node)
+    {
+      return (evaluator.*builtin)(*node.value.call);
+    }
 
     private: void builtinPrint(CallNode call);
 
-    private: Node builtinFloor(CallNode call);
+    private: Value builtinFloor(CallNode call);
+
+    private: Value builtinFloorValue(Value value, Position pos);
+
+    private: Value builtinSqrt(CallNode call);
+
+    private: Value builtinSin(CallNode call);
+
+    private: Value builtinCos(CallNode call);
+
+    private: Value builtinAtan2(CallNode call);
+
+    private: Value builtinPow(CallNode call);
+
+    private: void builtinMathBench(CallNode call);
 
     private: void builtinCd(CallNode call);
 
@@ -440,16 +888,82 @@ namespace NScript
 
     private: void builtinWrite(CallNode call);
 
-    private: Node builtinRead(CallNode call, Position pos);
+    private: Value builtinRead(CallNode call);
+
+    private: Value builtinLen(CallNode call);
+
+    private: void builtinPush(CallNode call);
+
+    private: Value builtinLines(CallNode call);
+
+    private: Value builtinJoin(CallNode call);
+
+    private: Value builtinGet(CallNode call);
+
+    private: void builtinSet(CallNode call);
+
+    private: Value builtinHas(CallNode call);
 
-    private: void expectArgsCount(CallNode call, uint64_t count);
+    private: void builtinDel(CallNode call);
 
-    private: std::string expectNonEmptyStringAndGetString(Node node);
+    private: Value builtinKeys(CallNode call);
+
+    private: Value builtinValues(CallNode call);
+
+    private: Value builtinMatch(CallNode call);
+
+    private: Value builtinFind(CallNode call);
+
+    private: Value builtinReplace(CallNode call);
+
+    private: Regex* expectRegex(Value value, Position pos);
+
+    private: Value builtinGrep(CallNode call);
+
+    private: uint32_t grepFile(Grep& grep, FILE* file, std::string path, bool printPath);
+
+    private: Value builtinFindFiles(CallNode call);
+
+    private: Value builtinDu(CallNode call);
+
+    private: void expectWalkerOpen(DirWalker& walker, std::string path, Position pathPos);
+
+    private: void builtinCp(CallNode call);
+
+    private: void builtinMv(CallNode call);
+
+    private: bool expectTransferPaths(CallNode call, std::string& src, std::string& dst);
+
+    private: void copyPath(std::string src, std::string dst, bool isFolder, Position pos);
+
+    // hashes the file the argument names, or the string itself with `fromString` (the `...str` builtins)
+    private: Value builtinHash(CallNode call, Hasher& hasher, bool fromString);
+
+    private: void builtinCompress(CallNode call);
+
+    private: void builtinDecompress(CallNode call);
+
+    // returns the destination path, so a failed transfer can remove it
+    private: std::string openTransferFiles(CallNode call, FILE*& in, FILE*& out);
+
+    private: void builtinHexdump(CallNode call);
+
+    private: Value builtinPeek(CallNode call);
+
+    private: FILE* openFileAt(Node pathArg, Node offsetArg);
+
+    private: void expectArgsCount(CallNode call, index_t count);
+
+    private: std::string expectNonEmptyStringAndGetString(Value value, Position pos);
 
     private: std::string getFullPath(std::string path, bool shouldBeFile);
 
-    private: Node expectType(Node node, NodeKind type);
+    private: Value expectType(Value value, NodeKind type, Position pos);
+
+    private: Value expectNumeric(Value value, Position pos);
+
+    private: float64 expectNumericAndGetFloat(Value value, Position pos);
 
-    private: std::string expectStringLengthAndGetString(Node node, std::function<bool(uint64_t)> f);
+    private: std::string expectStringLengthAndGetString(Value value, Position pos, std::function<bool(index_t)> f);
   };
 }
\ No newline at end of file
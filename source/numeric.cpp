@@ -0,0 +1,31 @@
+#include "numeric.h"
+
+#include <math.h>
+
+float64 Numeric::divideToFloat(int32_t num, int32_t den)
+{
+  // working on magnitudes, they always fit a signed 64 bits operand (even for INT32_MIN)
+  auto negative = (num < 0) != (den < 0);
+  auto n        = num < 0 ? -int64_t(num) : int64_t(num);
+  auto d        = den < 0 ? -int64_t(den) : int64_t(den);
+
+  // a result below 1 would waste the leading fraction bits, so the dividend is scaled up to the divisor's magnitude
+  auto scale = 0;
+
+  if (n != 0 && n < d)
+  {
+    scale = __builtin_clzll(n) - __builtin_clzll(d) + 1;
+    n   <<= scale;
+  }
+
+  // the integer part, then two 32 bits chunks of fraction, each remainder is smaller than `d` (<= 2^31)
+  // so shifting it left by 32 never overflows the signed numerator
+  auto integer = divMod64(n, d);
+  auto high    = divMod64(integer.rem << 32, d);
+  auto low     = divMod64(high.rem << 32, d);
+
+  auto fraction = (uint64_t(high.quot) << 32) | uint64_t(low.quot);
+  auto result   = ldexp(float64(integer.quot) + ldexp(float64(fraction), -64), -scale);
+
+  return negative ? -result : result;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <nds.h>
+
+#include "basics.h"
+
+// integer division and square root backend.
+// on the arm9 they are routed to the memory mapped divider and square root units (18-34 and 13 cycles),
+// instead of libgcc's __aeabi_idivmod/__aeabi_ldivmod loops, on the host they fall back to plain c arithmetic.
+// the units are shared, so these must not be called from interrupt handlers
+namespace Numeric
+{
+  class DivMod
+  {
+    public: int64_t quot;
+    public: int64_t rem;
+  };
+
+  // truncated division (like c), `den` must not be zero and INT32_MIN / -1 is not handled
+  static inline DivMod divMod32(int32_t num, int32_t den)
+  {
+#ifdef ARM9
+    REG_DIVCNT      = DIV_32_32;
+    REG_DIV_NUMER_L = num;
+    REG_DIV_DENOM_L = den;
+
+    while (REG_DIVCNT & DIV_BUSY);
+
+    return (DivMod) { .quot = REG_DIV_RESULT_L, .rem = REG_DIVREM_RESULT_L };
+#else
+    return (DivMod) { .quot = num / den, .rem = num % den };
+#endif
+  }
+
+  // truncated division (like c), `den` must not be zero and INT64_MIN / -1 is not handled
+  static inline DivMod divMod64(int64_t num, int64_t den)
+  {
+#ifdef ARM9
+    REG_DIVCNT    = DIV_64_64;
+    REG_DIV_NUMER = num;
+    REG_DIV_DENOM = den;
+
+    while (REG_DIVCNT & DIV_BUSY);
+
+    return (DivMod) { .quot = REG_DIV_RESULT, .rem = REG_DIVREM_RESULT };
+#else
+    return (DivMod) { .quot = num / den, .rem = num % den };
+#endif
+  }
+
+  // floor(sqrt(n))
+  static inline uint32_t sqrt64(uint64_t n)
+  {
+#ifdef ARM9
+    REG_SQRTCNT    = SQRT_64;
+    REG_SQRT_PARAM = int64_t(n);
+
+    while (REG_SQRTCNT & SQRT_BUSY);
+
+    return REG_SQRT_RESULT;
+#else
+    uint64_t root = 0;
+    uint64_t bit  = uint64_t(1) << 62;
+
+    while (bit > n)
+      bit >>= 2;
+
+    // digit by digit method in base 4
+    while (bit != 0)
+    {
+      if (n >= root + bit)
+      {
+        n   -= root + bit;
+        root = (root >> 1) + bit;
+      }
+      else
+        root >>= 1;
+
+      bit >>= 2;
+    }
+
+    return uint32_t(root);
+#endif
+  }
+
+  // floored division (rounds towards negative infinity), same constraints of `divMod32`
+  static inline int32_t floorDiv32(int32_t num, int32_t den)
+  {
+    auto r = divMod32(num, den);
+
+    return int32_t(r.rem != 0 && (num < 0) != (den < 0) ? r.quot - 1 : r.quot);
+  }
+
+  // num / den as a float, computed in 32.64 fixed point on the divider instead of a soft-float division.
+  // the result is truncated to 64 fractional bits before being rounded to float64, so it's within 1 ulp
+  float64 divideToFloat(int32_t num, int32_t den);
+}
\ No newline at end of file
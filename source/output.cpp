@@ -0,0 +1,75 @@
+#include "output.h"
+
+#include <stdio.h>
+
+void ConsoleOutput::write(const char* data, uint32_t length)
+{
+  if (length == 0)
+    return;
+
+  pushText(ConsoleOpKind::Text, length);
+  text.append(data, length);
+}
+
+void ConsoleOutput::write(const char* data, const uint8_t* palettes, uint32_t length)
+{
+  if (length == 0)
+    return;
+
+  pushText(ConsoleOpKind::Colored, length);
+
+  // the plain text in between gets palettes too, to keep the indexes shared
+  this->palettes.resize(text.length());
+  this->palettes.insert(this->palettes.end(), palettes, palettes + length);
+  text.append(data, length);
+}
+
+void ConsoleOutput::pushText(ConsoleOpKind kind, uint32_t length)
+{
+  // consecutive writes of the same kind extend the same op
+  if (!ops.empty() && ops.back().kind == kind && ops.back().start + ops.back().length == text.length())
+    ops.back().length += length;
+  else
+    ops.push_back({ .kind = kind, .c = 0, .start = uint32_t(text.length()), .length = length });
+}
+
+void ConsoleOutput::fill(char c, uint32_t count)
+{
+  if (count == 0)
+    return;
+
+  ops.push_back({ .kind = ConsoleOpKind::Fill, .c = c, .start = 0, .length = count });
+}
+
+void ConsoleOutput::setCursorX(uint32_t x)
+{
+  ops.push_back({ .kind = ConsoleOpKind::CursorX, .c = 0, .start = x, .length = 0 });
+}
+
+void ConsoleOutput::clearToEnd()
+{
+  ops.push_back({ .kind = ConsoleOpKind::ClearEnd, .c = 0, .start = 0, .length = 0 });
+}
+
+void ConsoleOutput::flush()
+{
+  // what was printed directly (by the builtins) came before the collected output
+  fflush(stdout);
+
+  for (const auto& op : ops)
+    switch (op.kind)
+    {
+      case ConsoleOpKind::Text:     screen->write(text.data() + op.start, op.length);                        break;
+      case ConsoleOpKind::Colored:  screen->write(text.data() + op.start, palettes.data() + op.start, op.length); break;
+      case ConsoleOpKind::Fill:     screen->fill(op.c, op.length);                                           break;
+      case ConsoleOpKind::CursorX:  screen->setCursorX(op.start);                                            break;
+      case ConsoleOpKind::ClearEnd: screen->clearToEnd();                                                    break;
+    }
+
+  screen->present();
+
+  // the text buffer keeps its capacity for the next frame
+  ops.clear();
+  text.clear();
+  palettes.clear();
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <nds.h>
+#include <nds/arm9/console.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+#include "sink.h"
+#include "screen.h"
+
+// room reserved for the text of a frame, a frame usually redraws just the prompt line
+#define CONSOLE_OUTPUT_CAPACITY 1024
+
+enum class ConsoleOpKind : uint8_t
+{
+  Text,     // `length` chars of the text buffer from `start`
+  Colored,  // the same, each char with the palette at the same index of the palettes buffer
+  Fill,     // `length` times the char `c`
+  CursorX,  // moves the cursor to the column `start` of the current line
+  ClearEnd, // cuts the current line at the cursor
+};
+
+struct ConsoleOp
+{
+  ConsoleOpKind kind;
+  char          c;
+  uint32_t      start;
+  uint32_t      length;
+};
+
+// collects the console output of a frame (text and cursor moves), then `flush` applies it to the text screen in one pass
+// and presents its changed cells, meant to be called at vblank. nothing goes through newlib's formatted io
+class ConsoleOutput : public OutputSink
+{
+  private: TextScreen*            screen;
+  private: std::vector<ConsoleOp> ops;
+  private: std::string            text;
+  private: std::vector<uint8_t>   palettes;  // as long as `text` up to the last colored op
+
+  public: ConsoleOutput()
+  {
+    this->screen = nullptr;
+  }
+
+  public: ConsoleOutput(TextScreen* screen)
+  {
+    this->screen = screen;
+
+    text.reserve(CONSOLE_OUTPUT_CAPACITY);
+  }
+
+  public: void write(const char* data, uint32_t length) override;
+
+  using OutputSink::write;
+
+  public: void write(const char* data, const uint8_t* palettes, uint32_t length);
+
+  public: void fill(char c, uint32_t count);
+
+  public: void setCursorX(uint32_t x);
+
+  public: void clearToEnd();
+
+  public: void flush();
+
+  private: void pushText(ConsoleOpKind kind, uint32_t length);
+};
\ No newline at end of file
@@ -0,0 +1,776 @@
+#include "regex.h"
+
+#include <c++/12.1.0/algorithm>
+
+enum class RegexNodeKind
+{
+  Set,
+  Empty,
+  Concat,
+  Alternate,
+  Star,
+  Plus,
+  Quest,
+  AssertStart,
+  AssertEnd,
+};
+
+class RegexNode
+{
+  public: RegexNodeKind kind;
+  public: uint32_t      set;
+  public: RegexNode*    left;
+  public: RegexNode*    right;
+
+  public: RegexNode(RegexNodeKind kind, RegexNode* left = nullptr, RegexNode* right = nullptr)
+  {
+    this->kind  = kind;
+    this->set   = 0;
+    this->left  = left;
+    this->right = right;
+  }
+
+  public: ~RegexNode()
+  {
+    delete left;
+    delete right;
+  }
+};
+
+// recursive descent over:
+//   alternate: concat ('|' concat)*
+//   concat:    repeat*
+//   repeat:    atom ('*' | '+' | '?')*
+//   atom:      '(' alternate ')' | '[' class ']' | '.' | '^' | '$' | '\' escape | char
+class RegexParser
+{
+  public:  std::string                pattern;
+  public:  std::vector<RegexCharSet>* sets;
+  public:  std::string                error;
+  private: uint32_t                   index = 0;
+
+  public: RegexNode* parse()
+  {
+    auto node = parseAlternate();
+
+    if (error.empty() && index < pattern.length())
+      error = "unbalanced `)`";
+
+    if (!error.empty())
+    {
+      delete node;
+      return nullptr;
+    }
+
+    return node;
+  }
+
+  private: bool isEnd()
+  {
+    return index >= pattern.length();
+  }
+
+  private: RegexNode* parseAlternate()
+  {
+    auto node = parseConcat();
+
+    while (error.empty() && !isEnd() && pattern[index] == '|')
+    {
+      index++;
+      node = new RegexNode(RegexNodeKind::Alternate, node, parseConcat());
+    }
+
+    return node;
+  }
+
+  private: RegexNode* parseConcat()
+  {
+    RegexNode* node = nullptr;
+
+    while (error.empty() && !isEnd() && pattern[index] != '|' && pattern[index] != ')')
+    {
+      auto repeat = parseRepeat();
+      node        = node == nullptr ? repeat : new RegexNode(RegexNodeKind::Concat, node, repeat);
+    }
+
+    return node == nullptr ? new RegexNode(RegexNodeKind::Empty) : node;
+  }
+
+  private: RegexNode* parseRepeat()
+  {
+    auto node = parseAtom();
+
+    while (error.empty() && !isEnd())
+    {
+      auto c = pattern[index];
+
+      if (c == '*')
+        node = new RegexNode(RegexNodeKind::Star, node);
+      else if (c == '+')
+        node = new RegexNode(RegexNodeKind::Plus, node);
+      else if (c == '?')
+        node = new RegexNode(RegexNodeKind::Quest, node);
+      else
+        break;
+
+      index++;
+    }
+
+    return node;
+  }
+
+  private: RegexNode* parseAtom()
+  {
+    auto c = pattern[index++];
+
+    switch (c)
+    {
+      case '(':
+      {
+        auto node = parseAlternate();
+
+        if (error.empty() && (isEnd() || pattern[index] != ')'))
+          error = "missing `)`";
+
+        index++;
+        return node;
+      }
+
+      case '^': return new RegexNode(RegexNodeKind::AssertStart);
+      case '$': return new RegexNode(RegexNodeKind::AssertEnd);
+
+      case '*':
+      case '+':
+      case '?':
+        error = std::string("nothing to repeat before `") + c + "`";
+        return nullptr;
+
+      default:
+        break;
+    }
+
+    auto set = RegexCharSet();
+
+    if (c == '[')
+      parseClass(set);
+    else if (c == '.')
+    {
+      setRange(set, 0, 255);
+      set.bits['\n' >> 5] &= ~(1u << ('\n' & 31));
+    }
+    else if (c == '\\')
+      parseEscape(set);
+    else
+      setRange(set, uint8_t(c), uint8_t(c));
+
+    auto node = new RegexNode(RegexNodeKind::Set);
+    node->set = sets->size();
+    sets->push_back(set);
+
+    return node;
+  }
+
+  private: void parseClass(RegexCharSet& set)
+  {
+    auto negated = !isEnd() && pattern[index] == '^';
+
+    if (negated)
+      index++;
+
+    // a leading `]` is a literal
+    auto first = true;
+
+    while (true)
+    {
+      if (isEnd())
+      {
+        error = "missing `]`";
+        return;
+      }
+
+      auto c = uint8_t(pattern[index++]);
+
+      if (c == ']' && !first)
+        break;
+
+      first = false;
+
+      if (c == '\\')
+      {
+        parseEscape(set);
+        continue;
+      }
+
+      if (index + 1 < pattern.length() && pattern[index] == '-' && pattern[index + 1] != ']')
+      {
+        auto last = uint8_t(pattern[index + 1]);
+        index    += 2;
+
+        if (last < c)
+        {
+          error = "bad range in `[...]`";
+          return;
+        }
+
+        setRange(set, c, last);
+      }
+      else
+        setRange(set, c, c);
+    }
+
+    if (negated)
+      for (auto& word : set.bits)
+        word = ~word;
+  }
+
+  private: void parseEscape(RegexCharSet& set)
+  {
+    if (isEnd())
+    {
+      error = "trailing `\\`";
+      return;
+    }
+
+    auto c     = pattern[index++];
+    auto klass = RegexCharSet();
+
+    switch (c)
+    {
+      case 'd': case 'D':
+        setRange(klass, '0', '9');
+        break;
+
+      case 'w': case 'W':
+        setRange(klass, '0', '9');
+        setRange(klass, 'a', 'z');
+        setRange(klass, 'A', 'Z');
+        setRange(klass, '_', '_');
+        break;
+
+      case 's': case 'S':
+        setRange(klass, ' ', ' ');
+        setRange(klass, '\t', '\r');
+        break;
+
+      case 'n': setRange(set, '\n', '\n'); return;
+      case 't': setRange(set, '\t', '\t'); return;
+      case 'r': setRange(set, '\r', '\r'); return;
+
+      default:
+        setRange(set, uint8_t(c), uint8_t(c));
+        return;
+    }
+
+    auto negated = c == 'D' || c == 'W' || c == 'S';
+
+    for (auto i = 0; i < 8; i++)
+      set.bits[i] |= negated ? ~klass.bits[i] : klass.bits[i];
+  }
+
+  private: static void setRange(RegexCharSet& set, uint8_t first, uint8_t last)
+  {
+    for (auto c = uint32_t(first); c <= last; c++)
+      set.bits[c >> 5] |= 1u << (c & 31);
+  }
+};
+
+// thompson construction, `reversed` emits the program of the reversed language (used to scan backwards)
+static void compileNode(std::vector<RegexInst>& program, RegexNode* node, bool reversed)
+{
+  auto emit = [&program](RegexOp op, uint32_t x = 0, uint32_t y = 0)
+  {
+    program.push_back((RegexInst) { .op = op, .x = x, .y = y });
+    return uint32_t(program.size() - 1);
+  };
+
+  switch (node->kind)
+  {
+    case RegexNodeKind::Set:
+      emit(RegexOp::Char, node->set);
+      break;
+
+    case RegexNodeKind::Empty:
+      break;
+
+    case RegexNodeKind::Concat:
+      compileNode(program, reversed ? node->right : node->left, reversed);
+      compileNode(program, reversed ? node->left : node->right, reversed);
+      break;
+
+    case RegexNodeKind::Alternate:
+    {
+      auto split = emit(RegexOp::Split);
+      program[split].x = program.size();
+      compileNode(program, node->left, reversed);
+
+      auto jump = emit(RegexOp::Jump);
+      program[split].y = program.size();
+      compileNode(program, node->right, reversed);
+
+      program[jump].x = program.size();
+      break;
+    }
+
+    case RegexNodeKind::Star:
+    {
+      auto split = emit(RegexOp::Split);
+      program[split].x = program.size();
+      compileNode(program, node->left, reversed);
+
+      emit(RegexOp::Jump, split);
+      program[split].y = program.size();
+      break;
+    }
+
+    case RegexNodeKind::Plus:
+    {
+      auto body = uint32_t(program.size());
+      compileNode(program, node->left, reversed);
+
+      emit(RegexOp::Split, body, program.size() + 1);
+      break;
+    }
+
+    case RegexNodeKind::Quest:
+    {
+      auto split = emit(RegexOp::Split);
+      program[split].x = program.size();
+      compileNode(program, node->left, reversed);
+
+      program[split].y = program.size();
+      break;
+    }
+
+    // scanning backwards the end of the text is where the scan starts, and the other way around
+    case RegexNodeKind::AssertStart:
+      emit(reversed ? RegexOp::AssertEnd : RegexOp::AssertStart);
+      break;
+
+    case RegexNodeKind::AssertEnd:
+      emit(reversed ? RegexOp::AssertStart : RegexOp::AssertEnd);
+      break;
+  }
+}
+
+static void compileProgram(RegexAutomaton& automaton, RegexNode* root, uint32_t anyCharSet, bool reversed)
+{
+  auto& program = automaton.program;
+
+  // unanchoredStart: split(anyChar, anchoredStart); anyChar; jump unanchoredStart
+  automaton.unanchoredStart = 0;
+  automaton.anchoredStart   = 3;
+
+  program.push_back((RegexInst) { .op = RegexOp::Split, .x = 1,          .y = 3 });
+  program.push_back((RegexInst) { .op = RegexOp::Char,  .x = anyCharSet, .y = 0 });
+  program.push_back((RegexInst) { .op = RegexOp::Jump,  .x = 0,          .y = 0 });
+
+  compileNode(program, root, reversed);
+  program.push_back((RegexInst) { .op = RegexOp::Match, .x = 0, .y = 0 });
+}
+
+Regex* Regex::compile(std::string pattern, std::string& error)
+{
+  auto regex = new Regex();
+  regex->pattern = pattern;
+
+  auto parser    = RegexParser();
+  parser.pattern = pattern;
+  parser.sets    = &regex->sets;
+
+  auto root = parser.parse();
+
+  if (root == nullptr)
+  {
+    error = parser.error;
+    delete regex;
+    return nullptr;
+  }
+
+  // the unanchored loop skips any byte, newlines included
+  auto anyChar = RegexCharSet();
+
+  for (auto& word : anyChar.bits)
+    word = 0xFFFFFFFF;
+
+  regex->sets.push_back(anyChar);
+
+  compileProgram(regex->forward,  root, regex->sets.size() - 1, false);
+  compileProgram(regex->backward, root, regex->sets.size() - 1, true);
+  delete root;
+
+  regex->computeByteClasses();
+  regex->forward.init(&regex->sets,  regex->byteClasses, regex->classesCount);
+  regex->backward.init(&regex->sets, regex->byteClasses, regex->classesCount);
+
+  return regex;
+}
+
+void Regex::computeByteClasses()
+{
+  // a new class begins at every byte where some set changes membership,
+  // so all the bytes of a class behave the same in every transition
+  classesCount   = 1;
+  byteClasses[0] = 0;
+
+  for (auto c = 1; c < 256; c++)
+  {
+    for (auto& set : sets)
+      if (set.contains(c) != set.contains(c - 1))
+      {
+        classesCount++;
+        break;
+      }
+
+    byteClasses[c] = classesCount - 1;
+  }
+}
+
+bool Regex::search(cstring_t text, uint32_t length)
+{
+  auto state = forward.startState(true, true);
+
+  for (uint32_t i = 0; i < length; i++)
+  {
+    if (forward.getState(state).accepting)
+      return true;
+
+    state = forward.step(state, text[i]);
+  }
+
+  return forward.getState(state).acceptingAtEnd;
+}
+
+std::vector<bool> Regex::findMatchStarts(cstring_t text, uint32_t length)
+{
+  auto starts = std::vector<bool>(length + 1, false);
+  auto state  = backward.startState(true, true);
+
+  // the backward automaton accepts at `i` when the reversed pattern matches text[i..j) read backwards,
+  // for some j, that is when a match of the pattern starts at `i`
+  for (auto i = length; i > 0; i--)
+  {
+    starts[i] = backward.getState(state).accepting;
+    state     = backward.step(state, text[i - 1]);
+  }
+
+  starts[0] = backward.getState(state).acceptingAtEnd;
+  return starts;
+}
+
+uint32_t Regex::longestMatchEnd(cstring_t text, uint32_t length, uint32_t start)
+{
+  auto state = forward.startState(false, start == 0);
+  auto end   = start;
+
+  for (auto i = start; i < length && !forward.getState(state).dead; i++)
+  {
+    state = forward.step(state, text[i]);
+
+    auto& current = forward.getState(state);
+
+    if (i + 1 == length ? current.acceptingAtEnd : current.accepting)
+      end = i + 1;
+  }
+
+  return end;
+}
+
+bool Regex::find(cstring_t text, uint32_t length, uint32_t& start, uint32_t& end)
+{
+  auto starts = findMatchStarts(text, length);
+
+  for (uint32_t i = 0; i <= length; i++)
+    if (starts[i])
+    {
+      start = i;
+      end   = longestMatchEnd(text, length, i);
+      return true;
+    }
+
+  return false;
+}
+
+std::string Regex::replace(cstring_t text, uint32_t length, std::string replacement)
+{
+  auto  starts     = findMatchStarts(text, length);
+  auto  result     = std::string();
+  auto  copied     = uint32_t(0);
+  auto  searchFrom = uint32_t(0);
+  auto  threads    = std::vector<RegexThread>();
+  auto  first      = size_t(0);               // threads before it are already in the result
+  auto  active     = std::vector<size_t>();   // the threads which are not finished, with their states in `pinned`
+  auto  marks      = std::vector<uint32_t>();
+  auto& states     = forward.pinned;
+
+  // where the match after `thread` may start, past an empty match the byte it stands before is kept
+  auto nextStart = [] (const RegexThread& thread)
+  {
+    return thread.end > thread.start ? thread.end : thread.start + 1;
+  };
+
+  auto emitFinished = [&] ()
+  {
+    // a finished thread is a match of the result once the ones before it are
+    for (; first < threads.size() && threads[first].finished; first++)
+    {
+      result.append(text + copied, threads[first].start - copied);
+      result    += replacement;
+      copied     = threads[first].end;
+      searchFrom = nextStart(threads[first]);
+    }
+
+    if (first == threads.size())
+    {
+      threads.clear();
+      first = 0;
+    }
+  };
+
+  states.clear();
+
+  // a thread per match which can't overlap the ones before it, the first is the next match of the result.
+  // when a thread finds a longer match, the ones after it started inside it and are dropped
+  for (uint32_t i = 0; i <= length; i++)
+  {
+    if (starts[i] && i >= (first == threads.size() ? searchFrom : nextStart(threads.back())))
+    {
+      threads.push_back({ .start = i, .end = i, .finished = false });
+      active.push_back(threads.size() - 1);
+      states.push_back(forward.startState(false, i == 0));
+    }
+
+    if (i == length)
+      break;
+
+    for (size_t a = 0; a < active.size(); a++)
+    {
+      states[a] = forward.step(states[a], text[i]);
+
+      auto& current = forward.getState(states[a]);
+
+      if (current.dead)
+        threads[active[a]].finished = true;
+      else if (i + 1 == length ? current.acceptingAtEnd : current.accepting)
+      {
+        threads[active[a]].end = i + 1;
+        threads.resize(active[a] + 1);
+        active.resize(a + 1);
+        states.resize(a + 1);
+      }
+    }
+
+    // a thread in the same state of an earlier one would match the same bytes from here, but any longer match
+    // of the earlier thread drops it, so its end is already the final one
+    auto kept = size_t(0);
+
+    for (size_t a = 0; a < active.size(); a++)
+    {
+      auto& thread = threads[active[a]];
+
+      if (thread.finished)
+        continue;
+
+      if (uint32_t(states[a]) >= marks.size())
+        marks.resize(states[a] + 1, 0);
+
+      if (marks[states[a]] == i + 1)
+      {
+        thread.finished = true;
+        continue;
+      }
+
+      marks[states[a]] = i + 1;
+      active[kept]     = active[a];
+      states[kept]     = states[a];
+      kept++;
+    }
+
+    active.resize(kept);
+    states.resize(kept);
+    emitFinished();
+  }
+
+  for (auto& thread : threads)
+    thread.finished = true;
+
+  emitFinished();
+  states.clear();
+
+  result.append(text + copied, length - copied);
+  return result;
+}
+
+void RegexAutomaton::init(const std::vector<RegexCharSet>* sets, const uint8_t* byteClasses, uint32_t classesCount)
+{
+  this->sets            = sets;
+  this->byteClasses     = byteClasses;
+  this->classesCount    = classesCount;
+  this->visitMarks      = std::vector<uint32_t>(program.size(), 0);
+  this->visitGeneration = 0;
+
+  for (auto& row : startStates)
+    row[0] = row[1] = REGEX_UNKNOWN_STATE;
+}
+
+int32_t RegexAutomaton::startState(bool unanchored, bool atTextStart)
+{
+  auto& cached = startStates[unanchored][atTextStart];
+
+  if (cached != REGEX_UNKNOWN_STATE)
+    return cached;
+
+  auto set = std::vector<uint32_t>();
+
+  visitGeneration++;
+  addClosure(set, unanchored ? unanchoredStart : anchoredStart, atTextStart, false);
+  std::sort(set.begin(), set.end());
+
+  auto flushed = false;
+  auto state   = findOrAddState(set, flushed);
+
+  // a flush resets every cached start state, this one included
+  startStates[unanchored][atTextStart] = state;
+  return state;
+}
+
+int32_t RegexAutomaton::computeStep(int32_t state, uint8_t c)
+{
+  auto set = std::vector<uint32_t>();
+
+  visitGeneration++;
+
+  for (auto pc : states[state].nfaStates)
+  {
+    auto& inst = program[pc];
+
+    if (inst.op == RegexOp::Char && (*sets)[inst.x].contains(c))
+      addClosure(set, pc + 1, false, false);
+  }
+
+  std::sort(set.begin(), set.end());
+
+  auto flushed = false;
+  auto next    = findOrAddState(set, flushed);
+
+  // after a flush `state` no longer exists, the transition will be computed again from the new states
+  if (!flushed)
+    states[state].next[byteClasses[c]] = next;
+
+  return next;
+}
+
+void RegexAutomaton::addClosure(std::vector<uint32_t>& set, uint32_t pc, bool atTextStart, bool atTextEnd)
+{
+  closureStack.push_back(pc);
+
+  while (!closureStack.empty())
+  {
+    pc = closureStack.back();
+    closureStack.pop_back();
+
+    if (visitMarks[pc] == visitGeneration)
+      continue;
+
+    visitMarks[pc] = visitGeneration;
+
+    auto& inst = program[pc];
+
+    switch (inst.op)
+    {
+      case RegexOp::Split:
+        closureStack.push_back(inst.y);
+        closureStack.push_back(inst.x);
+        break;
+
+      case RegexOp::Jump:
+        closureStack.push_back(inst.x);
+        break;
+
+      // the text start is only ever seen by the start state, so a failed `^` is dropped
+      case RegexOp::AssertStart:
+        if (atTextStart)
+          closureStack.push_back(pc + 1);
+        break;
+
+      // a pending `$` stays in the set, to be resolved if the text ends here
+      case RegexOp::AssertEnd:
+        if (atTextEnd)
+          closureStack.push_back(pc + 1);
+        else
+          set.push_back(pc);
+        break;
+
+      case RegexOp::Char:
+      case RegexOp::Match:
+        set.push_back(pc);
+        break;
+    }
+  }
+}
+
+int32_t RegexAutomaton::findOrAddState(std::vector<uint32_t> nfaStates, bool& flushed)
+{
+  auto found = statesIndex.find(nfaStates);
+
+  if (found != statesIndex.end())
+    return found->second;
+
+  if (states.size() >= REGEX_MAX_DFA_STATES)
+  {
+    auto kept = std::vector<std::vector<uint32_t>>();
+
+    for (auto state : pinned)
+      kept.push_back(state == REGEX_UNKNOWN_STATE ? std::vector<uint32_t>() : states[state].nfaStates);
+
+    states.clear();
+    statesIndex.clear();
+
+    for (auto& row : startStates)
+      row[0] = row[1] = REGEX_UNKNOWN_STATE;
+
+    flushed = true;
+
+    // the pinned states are still in use, they are the first ones of the new cache
+    for (size_t i = 0; i < pinned.size(); i++)
+      if (pinned[i] != REGEX_UNKNOWN_STATE)
+      {
+        found     = statesIndex.find(kept[i]);
+        pinned[i] = found != statesIndex.end() ? found->second : addState(kept[i]);
+      }
+  }
+
+  return addState(nfaStates);
+}
+
+int32_t RegexAutomaton::addState(std::vector<uint32_t> nfaStates)
+{
+  auto state           = RegexDfaState();
+  state.nfaStates      = nfaStates;
+  state.next           = std::vector<int32_t>(classesCount, REGEX_UNKNOWN_STATE);
+  state.dead           = nfaStates.empty();
+  state.accepting      = false;
+  state.acceptingAtEnd = false;
+
+  for (auto pc : nfaStates)
+    if (program[pc].op == RegexOp::Match)
+      state.accepting = true;
+
+  // resolving the pending `$`s tells whether the match can end with the text
+  auto atEnd = std::vector<uint32_t>();
+  visitGeneration++;
+
+  for (auto pc : nfaStates)
+    if (program[pc].op == RegexOp::AssertEnd)
+      addClosure(atEnd, pc + 1, false, true);
+
+  state.acceptingAtEnd = state.accepting;
+
+  for (auto pc : atEnd)
+    if (program[pc].op == RegexOp::Match)
+      state.acceptingAtEnd = true;
+
+  states.push_back(state);
+  statesIndex[nfaStates] = states.size() - 1;
+
+  return states.size() - 1;
+}
\ No newline at end of file
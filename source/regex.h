@@ -0,0 +1,134 @@
+#pragma once
+
+#include <nds.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+#include <c++/12.1.0/map>
+
+#include "basics.h"
+
+// when the lazily built dfa reaches this many states the cache is flushed and rebuilt on demand,
+// so memory stays bounded even for patterns whose full dfa would be exponential
+#define REGEX_MAX_DFA_STATES 128
+#define REGEX_UNKNOWN_STATE  -1
+
+enum class RegexOp
+{
+  Char,         // x: index of the char set to match
+  Split,        // x, y: both targets are followed
+  Jump,         // x: target
+  AssertStart,  // `^`
+  AssertEnd,    // `$`
+  Match,
+};
+
+class RegexInst
+{
+  public: RegexOp  op;
+  public: uint32_t x;
+  public: uint32_t y;
+};
+
+// 256 bits, one per byte value
+class RegexCharSet
+{
+  public: uint32_t bits[8];
+
+  public: inline bool contains(uint8_t c) const
+  {
+    return (bits[c >> 5] >> (c & 31)) & 1;
+  }
+};
+
+class RegexDfaState
+{
+  public: std::vector<uint32_t> nfaStates;      // sorted pcs of the Char, Match and pending AssertEnd instructions
+  public: std::vector<int32_t>  next;           // one transition per byte class, REGEX_UNKNOWN_STATE until computed
+  public: bool                  dead;           // no nfa state left, nothing can match from here
+  public: bool                  accepting;      // a match ends before the next byte
+  public: bool                  acceptingAtEnd; // a match ends here when this is the end of the text
+};
+
+// a thompson nfa program scanned through a lazily built dfa: every dfa state is a set of nfa states
+// and is only computed the first time a byte leads to it, then transitions are a table lookup
+class RegexAutomaton
+{
+  public:  std::vector<RegexInst>                   program;
+  public:  uint32_t                                 anchoredStart;
+  public:  uint32_t                                 unanchoredStart;  // `.*` loop before anchoredStart
+  public:  std::vector<int32_t>                     pinned;           // states added back (and renumbered in place) by a flush
+  private: const std::vector<RegexCharSet>*         sets;
+  private: const uint8_t*                           byteClasses;
+  private: uint32_t                                 classesCount;
+  private: std::vector<RegexDfaState>               states;
+  private: std::map<std::vector<uint32_t>, int32_t> statesIndex;
+  private: int32_t                                  startStates[2][2];  // [unanchored][atTextStart]
+  private: std::vector<uint32_t>                    visitMarks;
+  private: uint32_t                                 visitGeneration;
+  private: std::vector<uint32_t>                    closureStack;
+
+  public: void init(const std::vector<RegexCharSet>* sets, const uint8_t* byteClasses, uint32_t classesCount);
+
+  public: int32_t startState(bool unanchored, bool atTextStart);
+
+  // the returned index is the only valid one after the call, since the cache may have been flushed
+  public: inline int32_t step(int32_t state, uint8_t c)
+  {
+    auto next = states[state].next[byteClasses[c]];
+
+    return next != REGEX_UNKNOWN_STATE ? next : computeStep(state, c);
+  }
+
+  public: inline const RegexDfaState& getState(int32_t state)
+  {
+    return states[state];
+  }
+
+  private: int32_t computeStep(int32_t state, uint8_t c);
+
+  private: void addClosure(std::vector<uint32_t>& set, uint32_t pc, bool atTextStart, bool atTextEnd);
+
+  private: int32_t findOrAddState(std::vector<uint32_t> nfaStates, bool& flushed);
+
+  private: int32_t addState(std::vector<uint32_t> nfaStates);
+};
+
+// a match being extended while Regex::replace scans, the dfa states of the unfinished ones are pinned
+class RegexThread
+{
+  public: uint32_t start;
+  public: uint32_t end;       // of the longest match found so far
+  public: bool     finished;  // its end can't change anymore
+};
+
+// regular expressions over bytes with leftmost-longest semantics, matched in linear time (no backtracking).
+// syntax: literals, `.`, `[a-z]`, `[^...]`, `\d \w \s \D \W \S`, `^ $`, `( )`, `|`, `* + ?`
+class Regex
+{
+  public:  std::string               pattern;
+  private: std::vector<RegexCharSet> sets;
+  private: uint8_t                   byteClasses[256];  // bytes that no set tells apart share one class (and dfa column)
+  private: uint32_t                  classesCount;
+  private: RegexAutomaton            forward;
+  private: RegexAutomaton            backward;  // the reversed pattern, scanning from the end finds where matches start
+
+  // returns null and sets `error` when the pattern is malformed
+  public: static Regex* compile(std::string pattern, std::string& error);
+
+  // whether the pattern matches anywhere in the text
+  public: bool search(cstring_t text, uint32_t length);
+
+  // leftmost-longest match
+  public: bool find(cstring_t text, uint32_t length, uint32_t& start, uint32_t& end);
+
+  // replaces every non overlapping match, `replacement` is literal.
+  // the ends are found in a single forward pass, which extends the next matches while the previous one may still grow
+  public: std::string replace(cstring_t text, uint32_t length, std::string replacement);
+
+  // for each position, whether a match starts there, in one backward pass
+  private: std::vector<bool> findMatchStarts(cstring_t text, uint32_t length);
+
+  private: uint32_t longestMatchEnd(cstring_t text, uint32_t length, uint32_t start);
+
+  private: void computeByteClasses();
+};
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "screen.h"
+
+#include <string.h>
+
+TextScreen* TextScreen::active = nullptr;
+
+void VramScreenBackend::writeCells(uint32_t x, uint32_t y, const ScreenCell* cells, uint32_t count)
+{
+  auto target = map + y * stride + x;
+
+#ifdef ARM9
+  if (count >= SCREEN_DMA_MIN_CELLS)
+  {
+    // the entries are made in ram, then copied as a whole row span
+    static u16 row[SCREEN_COLUMNS] __attribute__((aligned(32)));
+
+    for (uint32_t i = 0; i < count; i++)
+      row[i] = (cells[i] & 0xF000) | u16((cells[i] & 0xFF) + charBase);
+
+    DC_FlushRange(row, count * sizeof(u16));
+    dmaCopyHalfWords(3, row, target, count * sizeof(u16));
+    return;
+  }
+#endif
+
+  for (uint32_t i = 0; i < count; i++)
+    target[i] = (cells[i] & 0xF000) | u16((cells[i] & 0xFF) + charBase);
+}
+
+void MemoryScreenBackend::writeCells(uint32_t x, uint32_t y, const ScreenCell* cells, uint32_t count)
+{
+  memcpy(this->cells + y * SCREEN_COLUMNS + x, cells, count * sizeof(ScreenCell));
+  cellWrites += count;
+}
+
+std::string MemoryScreenBackend::rowText(uint32_t y)
+{
+  auto text = std::string(SCREEN_COLUMNS, ' ');
+
+  for (uint32_t x = 0; x < SCREEN_COLUMNS; x++)
+    text[x] = charAt(x, y);
+
+  return text;
+}
+
+TextScreen::TextScreen(ScreenBackend* backend)
+{
+  this->backend              = backend;
+  this->palette              = 0;
+  this->newlinesSincePresent = 0;
+
+  // what the backend holds is unknown, the first present writes every cell
+  for (auto& cell : shadow)
+    cell = 0xFFFF;
+
+  clear();
+}
+
+void TextScreen::capture(PrintConsole* console)
+{
+  console->PrintChar = printChar;
+  active             = this;
+}
+
+void TextScreen::put(char c)
+{
+  changed = true;
+
+  switch (c)
+  {
+    case '\n':
+      newLine();
+      return;
+
+    case '\r':
+      cursorX = 0;
+      return;
+
+    case '\b':
+      if (cursorX > 0)
+        cursorX--;
+
+      return;
+
+    case '\t':
+      fill(' ', SCREEN_TAB_SIZE - cursorX % SCREEN_TAB_SIZE);
+      return;
+  }
+
+  auto start  = lineStarts.back();
+  auto length = log.size() - start;
+  auto cell   = makeScreenCell(c, palette);
+
+  // overwriting inside the line, or extending it (with spaces up to the cursor)
+  if (cursorX < length)
+    log[start + cursorX] = cell;
+  else
+  {
+    log.insert(log.end(), cursorX - length, makeScreenCell(' ', palette));
+    log.push_back(cell);
+  }
+
+  cursorX++;
+}
+
+void TextScreen::write(const char* chars, uint32_t length)
+{
+  for (uint32_t i = 0; i < length; i++)
+    put(chars[i]);
+}
+
+void TextScreen::write(const char* chars, const uint8_t* palettes, uint32_t length)
+{
+  auto current = palette;
+
+  for (uint32_t i = 0; i < length; i++)
+  {
+    palette = palettes[i] == SCREEN_CURRENT_PALETTE ? current : palettes[i];
+    put(chars[i]);
+  }
+
+  palette = current;
+}
+
+void TextScreen::fill(char c, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    put(c);
+}
+
+void TextScreen::setCursorX(uint32_t x)
+{
+  cursorX = x;
+}
+
+void TextScreen::clearToEnd()
+{
+  auto end = lineStarts.back() + cursorX;
+
+  if (end >= log.size())
+    return;
+
+  log.resize(end);
+  changed = true;
+}
+
+void TextScreen::clear()
+{
+  log.clear();
+  lineStarts = { 0 };
+  cursorX    = 0;
+  viewOffset = 0;
+  changed    = true;
+}
+
+void TextScreen::scroll(int32_t rows)
+{
+  auto totalRows = uint32_t(0);
+
+  for (uint32_t line = 0; line < lineCount(); line++)
+    totalRows += lineRows(line);
+
+  auto maxOffset = int64_t(totalRows > SCREEN_ROWS ? totalRows - SCREEN_ROWS : 0);
+  auto offset    = int64_t(viewOffset) + rows;
+
+  viewOffset = uint32_t(offset < 0 ? 0 : offset > maxOffset ? maxOffset : offset);
+  changed    = true;
+}
+
+void TextScreen::scrollToBottom()
+{
+  if (viewOffset == 0)
+    return;
+
+  viewOffset = 0;
+  changed    = true;
+}
+
+void TextScreen::setFooter(const ScreenCell* cells, uint32_t length)
+{
+  footer.assign(cells, cells + length);
+  changed = true;
+}
+
+void TextScreen::clearFooter()
+{
+  if (footer.empty())
+    return;
+
+  footer.clear();
+  changed = true;
+}
+
+uint32_t TextScreen::present()
+{
+  newlinesSincePresent = 0;
+
+  if (!changed)
+    return 0;
+
+  render();
+
+  auto written = uint32_t(0);
+
+  for (uint32_t y = 0; y < SCREEN_ROWS; y++)
+  {
+    auto row = cells + y * SCREEN_COLUMNS;
+    auto old = shadow + y * SCREEN_COLUMNS;
+    auto x   = uint32_t(0);
+
+    // each run of changed cells is one backend write
+    while (x < SCREEN_COLUMNS)
+    {
+      if (row[x] == old[x])
+      {
+        x++;
+        continue;
+      }
+
+      auto start = x;
+
+      while (x < SCREEN_COLUMNS && row[x] != old[x])
+        x++;
+
+      memcpy(old + start, row + start, (x - start) * sizeof(ScreenCell));
+      backend->writeCells(start, y, row + start, x - start);
+      written += x - start;
+    }
+  }
+
+  return written;
+}
+
+void TextScreen::newLine()
+{
+  lineStarts.push_back(log.size());
+  cursorX = 0;
+  newlinesSincePresent++;
+
+  if (log.size() <= SCREEN_LOG_CAPACITY)
+    return;
+
+  // dropping the oldest lines down to half the capacity, so this happens once in many lines
+  auto first = uint32_t(0);
+
+  while (first + 1 < lineStarts.size() && log.size() - lineStarts[first] > SCREEN_LOG_CAPACITY / 2)
+    first++;
+
+  auto dropped = lineStarts[first];
+
+  log.erase(log.begin(), log.begin() + dropped);
+  lineStarts.erase(lineStarts.begin(), lineStarts.begin() + first);
+
+  for (auto& start : lineStarts)
+    start -= dropped;
+}
+
+void TextScreen::render()
+{
+  changed = false;
+
+  // going back from the last line until the rows cover the view, short logs start at the top
+  auto wanted = SCREEN_ROWS + viewOffset;
+  auto line   = lineCount() - 1;
+  auto rows   = lineRows(line);
+
+  while (rows < wanted && line > 0)
+    rows += lineRows(--line);
+
+  // rows of the first line which are above the view
+  auto skip = rows > wanted ? rows - wanted : 0;
+  auto y    = uint32_t(0);
+
+  for (; line < lineCount() && y < SCREEN_ROWS; line++, skip = 0)
+  {
+    auto length = lineLength(line);
+
+    for (auto row = skip; row < lineRows(line) && y < SCREEN_ROWS; row++, y++)
+    {
+      auto from  = row * SCREEN_COLUMNS;
+      auto count = length - from < SCREEN_COLUMNS ? length - from : SCREEN_COLUMNS;
+      auto out   = cells + y * SCREEN_COLUMNS;
+
+      if (count > 0)
+        memcpy(out, lineCells(line) + from, count * sizeof(ScreenCell));
+
+      for (auto x = count; x < SCREEN_COLUMNS; x++)
+        out[x] = makeScreenCell(' ', 0);
+    }
+  }
+
+  for (; y < SCREEN_ROWS; y++)
+    for (uint32_t x = 0; x < SCREEN_COLUMNS; x++)
+      cells[y * SCREEN_COLUMNS + x] = makeScreenCell(' ', 0);
+}
+
+bool TextScreen::printChar(void* console, char c)
+{
+  // keeping the colors set by the ansi escapes libnds handles
+  active->palette = ((PrintConsole*)console)->fontCurPal >> 12;
+  active->put(c);
+
+  // a long command shows its output a screen at a time, not a line at a time
+  if (active->newlinesSincePresent == SCREEN_ROWS)
+    active->present();
+
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <nds.h>
+#include <nds/arm9/console.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// the text window of the top screen, as set up by `consoleInit` in main
+#define SCREEN_COLUMNS       32
+#define SCREEN_ROWS          24
+#define SCREEN_TAB_SIZE      4
+
+// cells of output kept for paging back, past it the oldest lines are dropped
+#define SCREEN_LOG_CAPACITY  (128 * 1024)
+
+// runs of changed cells at least this long are copied to vram by dma, shorter ones by the cpu
+#define SCREEN_DMA_MIN_CELLS 16
+
+// in a palettes array, the palette the screen is using
+#define SCREEN_CURRENT_PALETTE 0xFF
+
+// a char in the low byte and its palette in the top 4 bits, which is also where a bg map entry keeps it
+typedef uint16_t ScreenCell;
+
+inline ScreenCell makeScreenCell(char c, uint8_t palette)
+{
+  return ScreenCell(palette) << 12 | uint8_t(c);
+}
+
+// where the changed cells of a text screen end up
+class ScreenBackend
+{
+  public: virtual ~ScreenBackend() = default;
+
+  // `count` cells from the column `x` of the row `y`
+  public: virtual void writeCells(uint32_t x, uint32_t y, const ScreenCell* cells, uint32_t count) = 0;
+};
+
+// the bg map of a libnds console
+class VramScreenBackend : public ScreenBackend
+{
+  private: u16*     map;       // first entry of the console window
+  private: uint32_t stride;    // entries per map row
+  private: u16      charBase;  // tile index of char 0
+
+  public: VramScreenBackend(PrintConsole* console)
+  {
+    this->map      = console->fontBgMap + console->windowY * console->consoleWidth + console->windowX;
+    this->stride   = console->consoleWidth;
+    this->charBase = console->fontCharOffset - console->font.asciiOffset;
+  }
+
+  public: void writeCells(uint32_t x, uint32_t y, const ScreenCell* cells, uint32_t count) override;
+};
+
+// keeps the cells in memory, so the host can check the exact screen contents and how many cells a frame wrote
+class MemoryScreenBackend : public ScreenBackend
+{
+  public: ScreenCell cells[SCREEN_ROWS * SCREEN_COLUMNS];
+  public: uint64_t   cellWrites = 0;
+
+  public: MemoryScreenBackend()
+  {
+    for (auto& cell : cells)
+      cell = makeScreenCell(' ', 0);
+  }
+
+  public: void writeCells(uint32_t x, uint32_t y, const ScreenCell* cells, uint32_t count) override;
+
+  public: inline char charAt(uint32_t x, uint32_t y)
+  {
+    return char(cells[y * SCREEN_COLUMNS + x] & 0xFF);
+  }
+
+  public: inline uint8_t paletteAt(uint32_t x, uint32_t y)
+  {
+    return cells[y * SCREEN_COLUMNS + x] >> 12;
+  }
+
+  public: std::string rowText(uint32_t y);
+};
+
+// the console output kept as lines, of which only the visible window is rendered into the cells when something changed,
+// plus a shadow of what the backend holds, `present` writes only the cells which differ.
+// printing is just appending to the log, however long the output is, and the older rows are paged back on demand
+class TextScreen
+{
+  // the screen the console output (stdout) is drawn into, once captured
+  public: static TextScreen* active;
+
+  private: ScreenBackend*          backend;
+  private: ScreenCell              cells[SCREEN_ROWS * SCREEN_COLUMNS];
+  private: ScreenCell              shadow[SCREEN_ROWS * SCREEN_COLUMNS];
+  private: std::vector<ScreenCell> log;                 // all the lines one after the other
+  private: std::vector<uint32_t>   lineStarts;          // where each line starts in `log`, the last one is being written
+  private: std::vector<ScreenCell> footer;              // a transient line shown after the log, when not empty
+  private: uint32_t                viewOffset;          // rows the view is scrolled back from the bottom
+  private: uint32_t                newlinesSincePresent;
+  private: bool                    changed;             // whether the cells have to be rendered again
+  public:  uint32_t                cursorX;             // column in the last line
+  public:  uint8_t                 palette;
+
+  public: TextScreen(ScreenBackend* backend);
+
+  // makes libnds hand every char printed to the console over to this screen
+  public: void capture(PrintConsole* console);
+
+  public: void put(char c);
+
+  public: void write(const char* chars, uint32_t length);
+
+  // each char with its own palette
+  public: void write(const char* chars, const uint8_t* palettes, uint32_t length);
+
+  public: void fill(char c, uint32_t count);
+
+  public: void setCursorX(uint32_t x);
+
+  // cuts the last line at the cursor
+  public: void clearToEnd();
+
+  public: void clear();
+
+  // moves the view back (positive `rows`) or forward, within the log
+  public: void scroll(int32_t rows);
+
+  public: void scrollToBottom();
+
+  // shows `length` cells under the last line, without adding them to the log
+  public: void setFooter(const ScreenCell* cells, uint32_t length);
+
+  public: void clearFooter();
+
+  // returns the number of cells written to the backend
+  public: uint32_t present();
+
+  private: void newLine();
+
+  private: void render();
+
+  // the lines of the log, then the footer
+  private: inline uint32_t lineCount()
+  {
+    return lineStarts.size() + !footer.empty();
+  }
+
+  private: inline const ScreenCell* lineCells(uint32_t line)
+  {
+    return line < lineStarts.size() ? log.data() + lineStarts[line] : footer.data();
+  }
+
+  private: inline uint32_t lineLength(uint32_t line)
+  {
+    if (line == lineStarts.size())
+      return footer.size();
+
+    return (line + 1 < lineStarts.size() ? lineStarts[line + 1] : log.size()) - lineStarts[line];
+  }
+
+  // rows taken by a line, long lines wrap
+  private: inline uint32_t lineRows(uint32_t line)
+  {
+    auto length = lineLength(line);
+
+    return length == 0 ? 1 : (length + SCREEN_COLUMNS - 1) / SCREEN_COLUMNS;
+  }
+
+  private: static bool printChar(void* console, char c);
+};
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// destination of formatted text, values are written into it piece by piece instead of being concatenated first
+class OutputSink
+{
+  public: virtual ~OutputSink() = default;
+
+  public: virtual void write(const char* data, uint32_t length) = 0;
+
+  public: inline void write(cstring_t s)
+  {
+    write(s, strlen(s));
+  }
+
+  public: inline void write(const std::string& s)
+  {
+    write(s.data(), s.length());
+  }
+};
+
+// the console, through stdout
+class ConsoleSink : public OutputSink
+{
+  public: void write(const char* data, uint32_t length) override
+  {
+    fwrite(data, 1, length, stdout);
+  }
+
+  using OutputSink::write;
+};
+
+class FileSink : public OutputSink
+{
+  public: FILE* file;
+  public: bool  failed = false;
+
+  public: FileSink(FILE* file)
+  {
+    this->file = file;
+  }
+
+  public: void write(const char* data, uint32_t length) override
+  {
+    if (fwrite(data, 1, length, file) != length)
+      failed = true;
+  }
+
+  using OutputSink::write;
+};
+
+class StringSink : public OutputSink
+{
+  public: std::string result;
+
+  public: void write(const char* data, uint32_t length) override
+  {
+    result.append(data, length);
+  }
+
+  using OutputSink::write;
+};
\ No newline at end of file
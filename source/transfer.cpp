@@ -0,0 +1,127 @@
+#include "transfer.h"
+#include "walk.h"
+
+#include <errno.h>
+#include <malloc.h>
+#include <sys/stat.h>
+
+static char* transferBuffer = nullptr;
+
+char* Transfer::getBuffer()
+{
+  if (transferBuffer == nullptr)
+    transferBuffer = (char*)memalign(TRANSFER_BUFFER_ALIGN, TRANSFER_BUFFER_SIZE);
+
+  return transferBuffer;
+}
+
+bool Transfer::copyFile(cstring_t src, cstring_t dst, TransferStats& stats)
+{
+  auto buffer = getBuffer();
+
+  if (!buffer)
+    return false;
+
+  auto in = fopen(src, "rb");
+
+  if (!in)
+    return false;
+
+  auto out = fopen(dst, "wb");
+
+  if (!out)
+  {
+    fclose(in);
+    return false;
+  }
+
+  // every read and write is already a large block, stdio's own buffers would only add a copy
+  setvbuf(in,  nullptr, _IONBF, 0);
+  setvbuf(out, nullptr, _IONBF, 0);
+
+  auto ok = true;
+
+  while (auto read = fread(buffer, 1, TRANSFER_BUFFER_SIZE, in))
+  {
+    if (fwrite(buffer, 1, read, out) != read)
+    {
+      ok = false;
+      break;
+    }
+
+    stats.bytes += read;
+  }
+
+  ok = ok && !ferror(in);
+
+  fclose(in);
+  ok = !fclose(out) && ok;
+
+  if (!ok)
+  {
+    remove(dst);
+    return false;
+  }
+
+  stats.files++;
+  return true;
+}
+
+bool Transfer::copyFolder(std::string src, std::string dst, TransferStats& stats, std::string& failedPath)
+{
+  src = addTrailingSlashToPath(src);
+  dst = addTrailingSlashToPath(dst);
+
+  auto walker = DirWalker();
+
+  if (!walker.open(src) || (mkdir(dst.c_str(), 0777) && errno != EEXIST))
+  {
+    failedPath = src;
+    return false;
+  }
+
+  while (true)
+  {
+    auto event = walker.next();
+
+    if (event == WalkEvent::End)
+      return true;
+
+    if (event == WalkEvent::LeaveFolder)
+      continue;
+
+    // the entry's path relative to `src`, appended to `dst`
+    auto target = dst + (walker.path + src.length());
+
+    if (event == WalkEvent::EnterFolder ? mkdir(target.c_str(), 0777) && errno != EEXIST : !copyFile(walker.path, target.c_str(), stats))
+    {
+      failedPath = walker.path;
+      return false;
+    }
+  }
+}
+
+bool Transfer::sameVolume(std::string a, std::string b)
+{
+  auto volume = [] (std::string path)
+  {
+    auto colon = path.find(':');
+    return colon == std::string::npos ? std::string() : path.substr(0, colon);
+  };
+
+  return volume(a) == volume(b);
+}
+
+bool Transfer::sameFile(std::string a, std::string b)
+{
+  if (a == b)
+    return true;
+
+  struct stat infoA, infoB;
+
+  if (stat(a.c_str(), &infoA) || stat(b.c_str(), &infoB))
+    return false;
+
+  // libfat numbers a file by its first cluster, which empty files don't have
+  return infoA.st_ino != 0 && infoA.st_dev == infoB.st_dev && infoA.st_ino == infoB.st_ino;
+}
\ No newline at end of file
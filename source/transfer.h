@@ -0,0 +1,37 @@
+#pragma once
+
+#include <nds.h>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// files are moved through one buffer allocated on first use and kept for the next transfers.
+// it's aligned to the arm9 cache lines and spans many sectors, so libfat can transfer whole sectors
+// straight into it (with stdio buffering disabled) instead of going through its sector cache
+#define TRANSFER_BUFFER_SIZE  (128 * 1024)
+#define TRANSFER_BUFFER_ALIGN 32
+
+class TransferStats
+{
+  public: uint32_t files = 0;
+  public: uint64_t bytes = 0;
+};
+
+namespace Transfer
+{
+  // the shared TRANSFER_BUFFER_SIZE bytes buffer, also used by the other streaming builtins, null when it can't be allocated
+  char* getBuffer();
+
+  // false when the buffer can't be allocated, either file can't be opened or a write fails, the partial destination is removed
+  bool copyFile(cstring_t src, cstring_t dst, TransferStats& stats);
+
+  // copies the subtree of the `src` folder into the `dst` folder, which is created.
+  // stops at the first failure, setting `failedPath` to the entry which couldn't be copied
+  bool copyFolder(std::string src, std::string dst, TransferStats& stats, std::string& failedPath);
+
+  // whether both paths are on the same device (`sd:/`, `fat:/` or the default one), so a rename can move them
+  bool sameVolume(std::string a, std::string b);
+
+  // whether both paths name the same existing file, so opening one for writing would truncate the other
+  bool sameFile(std::string a, std::string b);
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "walk.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+DirWalker::~DirWalker()
+{
+  for (auto& frame : frames)
+    closedir(frame.dir);
+}
+
+bool DirWalker::open(std::string root)
+{
+  if (root.length() + 1 > WALK_PATH_CAPACITY)
+    return false;
+
+  auto dir = opendir(root.c_str());
+
+  if (!dir)
+    return false;
+
+  memcpy(path, root.c_str(), root.length() + 1);
+  pathLength = root.length();
+  nameStart  = pathLength;
+
+  frames.push_back((WalkFrame) { .dir = dir, .pathLength = pathLength });
+  return true;
+}
+
+WalkEvent DirWalker::next()
+{
+  while (!frames.empty())
+  {
+    auto& frame = frames.back();
+
+    // dropping the previous entry's name, back to the path of the folder being read
+    pathLength       = frame.pathLength;
+    path[pathLength] = '\0';
+
+    auto entry = readdir(frame.dir);
+
+    if (!entry)
+    {
+      closedir(frame.dir);
+      frames.pop_back();
+
+      // pointing `nameStart` at the name of the folder being left
+      nameStart = pathLength - 1;
+
+      while (nameStart > 0 && path[nameStart - 1] != '/')
+        nameStart--;
+
+      return WalkEvent::LeaveFolder;
+    }
+
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+
+    auto nameLength = strlen(entry->d_name);
+
+    // room for the name, a trailing `/` and the terminator
+    if (pathLength + nameLength + 2 > WALK_PATH_CAPACITY)
+      continue;
+
+    memcpy(path + pathLength, entry->d_name, nameLength + 1);
+    nameStart   = pathLength;
+    pathLength += nameLength;
+
+    auto isFolder = entry->d_type == DT_DIR;
+
+    // only when the file system doesn't fill dirent.d_type
+    if (entry->d_type == DT_UNKNOWN)
+    {
+      struct stat info;
+      isFolder = !stat(path, &info) && S_ISDIR(info.st_mode);
+    }
+
+    if (!isFolder)
+      return WalkEvent::File;
+
+    path[pathLength++] = '/';
+    path[pathLength]   = '\0';
+
+    // unreadable folders are skipped
+    auto dir = opendir(path);
+
+    if (!dir)
+      continue;
+
+    frames.push_back((WalkFrame) { .dir = dir, .pathLength = pathLength });
+    return WalkEvent::EnterFolder;
+  }
+
+  return WalkEvent::End;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <nds.h>
+#include <dirent.h>
+#include <c++/12.1.0/vector>
+#include <c++/12.1.0/string>
+
+#include "basics.h"
+
+// longest path the walker can build, entries that would exceed it are skipped (libfat caps paths at 768 bytes)
+#define WALK_PATH_CAPACITY 1024
+
+enum class WalkEvent
+{
+  File,         // any entry which is not a folder
+  EnterFolder,  // the folder's entries follow
+  LeaveFolder,  // all the folder's entries were visited (also sent for the root, last)
+  End,
+};
+
+class WalkFrame
+{
+  public: DIR*     dir;
+  public: uint32_t pathLength;  // of the folder's path, trailing `/` included
+};
+
+// depth first traversal of a subtree in a single pass.
+// each folder is opened once and kept open while its entries are visited (one handle per depth level),
+// the path of the current entry is built in place into a single buffer, instead of a string per entry
+class DirWalker
+{
+  public:  char                   path[WALK_PATH_CAPACITY];  // path of the current entry, folders end with `/`
+  public:  uint32_t               pathLength;
+  public:  uint32_t               nameStart;  // index of the current entry's name into `path`
+  private: std::vector<WalkFrame> frames;
+
+  public: DirWalker() = default;
+
+  public: DirWalker(const DirWalker&) = delete;
+
+  public: ~DirWalker();
+
+  // `root` must end with `/`, returns false when it can't be opened
+  public: bool open(std::string root);
+
+  public: WalkEvent next();
+};
\ No newline at end of file